@@ -0,0 +1,12 @@
+#ifndef BENCH_NET_DOM_REFERENCE_H
+#define BENCH_NET_DOM_REFERENCE_H
+
+#include "netlist/types.h"
+#include <string>
+#include <vector>
+
+// Nets por bloco (uma por pad de entrada e por CLB, nomeada pelo bloco)
+// montadas sobre o DOM completo; vazio se o arquivo faltar ou estiver malformado
+std::vector<Net> read_net_file_dom(const std::string& filename);
+
+#endif
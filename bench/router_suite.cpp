@@ -0,0 +1,325 @@
+// Suíte de desempenho do roteador com dispositivo e netlist sintéticos.
+// Gera uma arquitetura no estilo k6_frac_N10 (io no perímetro, clb no
+// miolo, fios L=4), um netlist empacotado aleatório com fanout e
+// localidade controláveis e o placement correspondente. Mede separadamente
+// construção do grafo, mapeamento das nets e roteamento.
+//
+// Uso: router_suite [--nets N[,N...]] [--fanout F] [--locality P] [--radius R]
+//                   [--chan-width W] [--threads T] [--iterations I] [--seed S]
+//                   [--queue binary|4ary|radix] [--astar-fac F] [--bidir-span S]
+//                   [--no-route]
+#include "routing/graph_builder.h"
+#include "routing/router.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+
+struct SuiteParams {
+    std::vector<int> sizes = {1000, 5000};
+    double mean_fanout = 2.5;  // Fanout médio (distribuição geométrica, >= 1)
+    int max_fanout = 64;
+    double locality = 0.9;     // Fração dos sinks sorteada perto do driver
+    int radius = 2;            // Distância máxima (células) de um sink local
+    int channel_width = 120;
+    int threads = 1;
+    int max_iterations = 30;
+    unsigned seed = 1;
+    QueueKind queue = QueueKind::FOUR_ARY_HEAP;
+    float astar_fac = RouterOptions().astar_fac;
+    int bidir_min_span = RouterOptions().bidir_min_span;  // Só com astar_fac = 0
+    bool route = true;         // false = só construção e mapeamento (tamanhos grandes)
+};
+
+// Projeto sintético: netlist e placement num grid grid_width x grid_height
+struct SyntheticDesign {
+    PackedNetlist netlist;
+    std::vector<Placement> placements;
+    int grid_width = 0;
+    int grid_height = 0;
+};
+
+// Descarta a saída (log por net do roteador)
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+};
+
+static const int CLB_INPUTS = 40;
+static const int CLB_OUTPUTS = 20;
+static const int CLB_USED_OUTPUTS = 6;  // Saídas de cada clb que dirigem nets
+static const int IO_CAPACITY = 8;
+
+static Port makePort(const std::string& name, const std::string& type, int num_pins, bool equivalent) {
+    return {name, type, num_pins, type == "clock", equivalent};
+}
+
+// Arquitetura equivalente à k6_frac_N10_mem32K_40nm sem os blocos rígidos
+static FPGAArchitecture makeSyntheticArch() {
+    FPGAArchitecture arch;
+    arch.device = {0.0, 0.0, 0.0, "wilton", "ipin_cblock", 3};
+    arch.switches.push_back({"mux", "0", 551, 0.77e-15, 4e-15, 58e-12, 2.63, 27.6});
+    arch.switches.push_back({"mux", "ipin_cblock", 2231.5, 1.47e-15, 0.0, 7.247e-11, 1.22, 0.0});
+    arch.segments.push_back({1.0, 4, "unidir", 101, 22.5e-15, "0"});
+
+    Tile io;
+    io.name = io.type = "io";
+    io.height = 1;
+    io.capacity = IO_CAPACITY;
+    io.area = 0;
+    io.fc_in = 0.15;
+    io.fc_out = 0.10;
+    io.ports = {makePort("outpad", "input", 1, false), makePort("inpad", "output", 1, false),
+                makePort("clock", "clock", 1, false)};
+
+    Tile clb;
+    clb.name = clb.type = "clb";
+    clb.height = 1;
+    clb.capacity = 1;
+    clb.area = 53894;
+    clb.fc_in = 0.15;
+    clb.fc_out = 0.10;
+    clb.ports = {makePort("I", "input", CLB_INPUTS, true), makePort("O", "output", CLB_OUTPUTS, false),
+                 makePort("clk", "clock", 1, false)};
+
+    arch.tiles = {io, clb};
+    arch.layout.aspect_ratio = 1.0;
+    arch.layout.rules = {{"perimeter", "io", 100, 0, 0, 0, 0},
+                         {"corners", "EMPTY", 101, 0, 0, 0, 0},
+                         {"fill", "clb", 10, 0, 0, 0, 0}};
+    return arch;
+}
+
+static SyntheticDesign makeSyntheticDesign(int num_nets, const SuiteParams& params, std::mt19937& rng) {
+    SyntheticDesign design;
+    PackedNetlist& netlist = design.netlist;
+    netlist.block_types = {"io", "clb"};
+    netlist.port_names = {"I", "O", "inpad", "outpad"};
+    const int PORT_I = 0, PORT_O = 1, PORT_INPAD = 2, PORT_OUTPAD = 3;
+
+    // Grid com ~80% do miolo ocupado por clbs; io limitado às posições do perímetro
+    int num_clbs = (num_nets + CLB_USED_OUTPUTS - 1) / CLB_USED_OUTPUTS;
+    int inner = static_cast<int>(std::ceil(std::sqrt(num_clbs / 0.8)));
+    design.grid_width = design.grid_height = inner + 2;
+    int io_slots = 4 * inner * IO_CAPACITY;
+    int num_inpads = std::min(num_nets / 20, io_slots * 6 / 10);
+    int num_outpads = std::min(num_nets / 50, io_slots * 3 / 10);
+    num_clbs = (num_nets - num_inpads + CLB_USED_OUTPUTS - 1) / CLB_USED_OUTPUTS;
+
+    // Posições embaralhadas: clbs no miolo, io no perímetro sem os cantos
+    std::vector<std::pair<int, int>> cells;
+    for (int y = 1; y <= inner; ++y) {
+        for (int x = 1; x <= inner; ++x) cells.push_back({x, y});
+    }
+    std::shuffle(cells.begin(), cells.end(), rng);
+    std::vector<std::pair<int, int>> io_cells;
+    for (int i = 1; i <= inner; ++i) {
+        io_cells.push_back({i, 0});
+        io_cells.push_back({i, inner + 1});
+        io_cells.push_back({0, i});
+        io_cells.push_back({inner + 1, i});
+    }
+    std::shuffle(io_cells.begin(), io_cells.end(), rng);
+
+    const int W = design.grid_width;
+    std::vector<int> clb_at(W * design.grid_height, -1);
+    auto addBlock = [&](int type, int x, int y, int z) {
+        int index = static_cast<int>(netlist.blocks.size());
+        std::string name = "b" + std::to_string(index);
+        netlist.blocks.push_back({name, type, "default"});
+        design.placements.push_back({name, x, y, z, index, ""});
+        return index;
+    };
+    for (int c = 0; c < num_clbs; ++c) {
+        int block = addBlock(1, cells[c].first, cells[c].second, 0);
+        clb_at[cells[c].second * W + cells[c].first] = block;
+    }
+    std::vector<int> inpads, outpads;
+    for (int i = 0; i < num_inpads + num_outpads; ++i) {
+        const auto& cell = io_cells[(i / IO_CAPACITY) % io_cells.size()];
+        int block = addBlock(0, cell.first, cell.second, i % IO_CAPACITY);
+        (i < num_inpads ? inpads : outpads).push_back(block);
+    }
+
+    // Drivers: saídas dos clbs e pads de entrada, em ordem aleatória
+    std::vector<NetPin> drivers;
+    for (int c = 0; c < num_clbs; ++c) {
+        for (int pin = 0; pin < CLB_USED_OUTPUTS; ++pin) drivers.push_back({c, PORT_O, pin});
+    }
+    for (int block : inpads) drivers.push_back({block, PORT_INPAD, 0});
+    std::shuffle(drivers.begin(), drivers.end(), rng);
+    drivers.resize(std::min<size_t>(drivers.size(), num_nets));
+
+    // Sinks: entradas livres de clbs perto do driver (locality) ou em qualquer lugar
+    std::vector<int> free_inputs(num_clbs, CLB_INPUTS);
+    std::geometric_distribution<int> extra_fanout(1.0 / std::max(1.0, params.mean_fanout));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> offset(-params.radius, params.radius);
+    auto pickSink = [&](int driver_block) {
+        const Placement& at = design.placements[driver_block];
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            int block;
+            if (unit(rng) < params.locality) {
+                int x = at.x + offset(rng), y = at.y + offset(rng);
+                if (x < 1 || y < 1 || x >= W - 1 || y >= design.grid_height - 1) continue;
+                block = clb_at[y * W + x];
+            } else {
+                block = static_cast<int>(rng() % num_clbs);
+            }
+            if (block >= 0 && block != driver_block && free_inputs[block] > 0) return block;
+        }
+        return -1;
+    };
+
+    netlist.nets.resize(drivers.size());
+    for (size_t n = 0; n < drivers.size(); ++n) {
+        PackedNet& net = netlist.nets[n];
+        net.name = "n" + std::to_string(n);
+        net.driver = drivers[n];
+        int fanout = std::min(params.max_fanout, 1 + extra_fanout(rng));
+        for (int k = 0; k < fanout; ++k) {
+            int block = pickSink(net.driver.block);
+            if (block < 0) continue;
+            net.sinks.push_back({block, PORT_I, CLB_INPUTS - free_inputs[block]--});
+        }
+        
+        // Net sem sink nunca fica roteada: a primeira entrada livre serve
+        for (int i = 0, first = static_cast<int>(rng() % num_clbs); i < num_clbs && net.sinks.empty(); ++i) {
+            int block = (first + i) % num_clbs;
+            if (block == net.driver.block || free_inputs[block] == 0) continue;
+            net.sinks.push_back({block, PORT_I, CLB_INPUTS - free_inputs[block]--});
+        }
+    }
+    for (size_t i = 0; i < outpads.size() && !netlist.nets.empty(); ++i) {
+        netlist.nets[rng() % netlist.nets.size()].sinks.push_back({outpads[i], PORT_OUTPAD, 0});
+    }
+    return design;
+}
+
+static double peakRssMB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;  // ru_maxrss em KB no Linux
+}
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void runSize(int num_nets, const SuiteParams& params, const FPGAArchitecture& arch) {
+    std::mt19937 rng(params.seed);
+    SyntheticDesign design = makeSyntheticDesign(num_nets, params, rng);
+
+    NullBuffer null_buffer;
+    auto* old_buf = std::cout.rdbuf(&null_buffer);
+
+    GraphBuildOptions graph_options;
+    graph_options.channel_width = params.channel_width;
+    graph_options.num_threads = params.threads;
+    RoutingGraphBuilder builder(graph_options);
+    auto start = std::chrono::steady_clock::now();
+    RoutingGraph graph = builder.buildGraph(arch, design.grid_width, design.grid_height);
+    double build_ms = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<Net> nets;
+    builder.mapNetsToPhysicalNodes(design.netlist, design.placements, arch, nets, graph);
+    double map_ms = msSince(start);
+
+    RouterOptions router_options;
+    router_options.num_threads = params.threads;
+    router_options.max_iterations = params.max_iterations;
+    router_options.log_nets = false;
+    router_options.queue = params.queue;
+    router_options.astar_fac = params.astar_fac;
+    router_options.bidir_min_span = params.bidir_min_span;
+    Router router(router_options);
+    std::vector<RouteTree> routes;
+    start = std::chrono::steady_clock::now();
+    if (params.route) routes = router.route(graph, nets);
+    double route_ms = msSince(start);
+
+    std::cout.rdbuf(old_buf);
+
+    long long routed = std::count_if(routes.begin(), routes.end(),
+                                     [](const RouteTree& r) { return r.routed; });
+    double route_s = params.route ? route_ms / 1000.0 : 0.0;
+    std::cout << std::setw(9) << num_nets
+              << std::setw(9) << design.grid_width
+              << std::setw(11) << graph.nodes.size()
+              << std::setw(10) << build_ms
+              << std::setw(9) << map_ms
+              << std::setw(11) << route_ms
+              << std::setw(10) << (route_s > 0 ? routed / route_s : 0.0)
+              << std::setw(9) << (route_s > 0 ? router.stats().nodes_expanded / route_s / 1e6 : 0.0)
+              << std::setw(6) << router.iterations()
+              << std::setw(7) << (!params.route ? "-" : router.isLegal() ? "sim" : "não")
+              << std::setw(10) << peakRssMB() << std::endl;
+}
+
+// Lista "1000,10000" -> {1000, 10000}
+static std::vector<int> parseSizes(const char* text) {
+    std::vector<int> sizes;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int size = std::atoi(item.c_str());
+        if (size > 0) sizes.push_back(size);
+    }
+    return sizes;
+}
+
+int main(int argc, char** argv) {
+    SuiteParams params;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--nets") == 0 && has_value) {
+            params.sizes = parseSizes(argv[++i]);
+        } else if (std::strcmp(argv[i], "--fanout") == 0 && has_value) {
+            params.mean_fanout = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--locality") == 0 && has_value) {
+            params.locality = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--radius") == 0 && has_value) {
+            params.radius = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--chan-width") == 0 && has_value) {
+            params.channel_width = std::max(2, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            params.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && has_value) {
+            params.max_iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            params.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--queue") == 0 && has_value) {
+            parse_queue_kind(argv[++i], params.queue);
+        } else if (std::strcmp(argv[i], "--astar-fac") == 0 && has_value) {
+            params.astar_fac = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        } else if (std::strcmp(argv[i], "--bidir-span") == 0 && has_value) {
+            params.bidir_min_span = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--no-route") == 0) {
+            params.route = false;
+        }
+    }
+
+    FPGAArchitecture arch = makeSyntheticArch();
+    std::cout << "fanout médio " << params.mean_fanout << ", localidade " << params.locality
+              << " (raio " << params.radius << "), W=" << params.channel_width
+              << ", threads " << params.threads << ", seed " << params.seed
+              << ", fila " << queue_kind_name(params.queue)
+              << ", astar_fac " << params.astar_fac
+              << ", bidirecional a partir de " << params.bidir_min_span << "\n";
+    std::cout << std::setw(9) << "nets" << std::setw(9) << "grid" << std::setw(11) << "nós RR"
+              << std::setw(10) << "build ms" << std::setw(9) << "map ms" << std::setw(11) << "route ms"
+              << std::setw(10) << "nets/s" << std::setw(9) << "Mexp/s" << std::setw(6) << "it"
+              << std::setw(7) << "legal" << std::setw(10) << "RSS MB" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (int size : params.sizes) {
+        runSize(size, params, arch);
+    }
+    return 0;
+}
@@ -0,0 +1,847 @@
+// Benchmarks do roteador:
+//  1. tempo por net deve ficar constante quando o número de arestas do
+//     grafo cresce (expansão O(grau) por nó);
+//  2. heap pushes por conexão com Dijkstra puro vs A* com lookahead;
+//  3. tempo de construção do RR graph real por número de threads;
+//  4. vazão (MB/s) da leitura do .net: streaming por pino vs DOM;
+//  5. mapeamento dos terminais por placement (deve ser linear);
+//  6. STA: análise completa vs incremental após rerotear 1% das nets;
+//  7. ECO: tempo de reroteamento incremental pelo número de nets alteradas;
+//  8. escrita/leitura de 10M nós roteados: .route texto vs binário;
+//  9. backends da fila de prioridade (binário, 4-ário, radix) no grid e no
+//     RR graph da arquitetura real;
+// 10. busca bidirecional (Dijkstra) vs unidirecional, com e sem A*;
+// 11. ocupação: reset por época e resumo incremental do sobreuso vs
+//     varredura de todos os nós;
+// 12. arquitetura: parse do XML vs cache binário, e modo em lote por
+//     número de threads.
+#include "routing/router.h"
+#include "routing/eco.h"
+#include "routing/route_file.h"
+#include "routing/graph_builder.h"
+#include "routing/timing.h"
+#include "../src/architecture/parser.h"
+#include "../src/architecture/cache.h"
+#include "../src/netlist/parser.h"
+#include "net_dom_reference.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+// Grid width x width com arestas nos 4 vizinhos; extra_edges arestas
+// paralelas são adicionadas no canto oposto, longe das nets roteadas.
+static RoutingGraph makeGridGraph(int width, int extra_edges) {
+    RoutingGraph graph;
+    for (int y = 0; y < width; ++y) {
+        for (int x = 0; x < width; ++x) {
+            RRNode node;
+            node.id = y * width + x;
+            node.type = RRNodeType::CHANX;
+            node.x = x;
+            node.y = y;
+            node.x_low = node.x_high = x;
+            node.y_low = node.y_high = y;
+            node.ptc = 0;
+            node.capacity = 1;
+            node.base_cost = 1.0f;
+            node.delay = 0.1f;
+            graph.addNode(node);
+        }
+    }
+    
+    auto id = [width](int x, int y) { return y * width + x; };
+    for (int y = 0; y < width; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (x + 1 < width) {
+                graph.addEdge({id(x, y), id(x + 1, y), 0, 0.05f});
+                graph.addEdge({id(x + 1, y), id(x, y), 0, 0.05f});
+            }
+            if (y + 1 < width) {
+                graph.addEdge({id(x, y), id(x, y + 1), 0, 0.05f});
+                graph.addEdge({id(x, y + 1), id(x, y), 0, 0.05f});
+            }
+        }
+    }
+    
+    int far = width - 2;
+    for (int i = 0; i < extra_edges; ++i) {
+        graph.addEdge({id(far, far), id(far + 1, far), 1, 0.07f});
+    }
+    
+    graph.freeze();
+    return graph;
+}
+
+// Silencia std::cout enquanto existir (logs do roteador e do builder)
+class QuietOutput {
+public:
+    QuietOutput() : old_buf_(std::cout.rdbuf(sink_.rdbuf())) {}
+    ~QuietOutput() { std::cout.rdbuf(old_buf_); }
+    QuietOutput(const QuietOutput&) = delete;
+    QuietOutput& operator=(const QuietOutput&) = delete;
+
+private:
+    std::ostringstream sink_;
+    std::streambuf* old_buf_;
+};
+
+// Roteia nets silenciando o log por net do roteador
+static std::vector<RouteTree> routeQuiet(Router& router, RoutingGraph& graph,
+                                         const std::vector<Net>& nets) {
+    QuietOutput quiet;
+    return router.route(graph, nets);
+}
+
+// Arquitetura real, no mesmo caminho relativo do fpga_router: rodar a
+// partir do diretório de build
+const char* const BENCH_ARCH_FILE = "../data/k6_frac_N10_mem32K_40nm.xml";
+
+// Vazia (sem tiles) se o XML não for encontrado
+static FPGAArchitecture loadBenchArch() {
+    return parse_architecture_xml(BENCH_ARCH_FILE);
+}
+
+// Arquivos de rascunho num diretório temporário do processo, removido
+// ao fim do main
+static std::filesystem::path benchTempDir() {
+    static const std::filesystem::path dir = [] {
+        auto path = std::filesystem::temp_directory_path() /
+                    ("fpga_router_bench." + std::to_string(getpid()));
+        std::filesystem::create_directories(path);
+        return path;
+    }();
+    return dir;
+}
+
+static std::string benchTempPath(const std::string& name) {
+    return (benchTempDir() / name).string();
+}
+
+// 20 conexões longas atravessando o grid width x width na diagonal
+// (width >= 162 para os terminais ficarem dentro do grid)
+static std::vector<Net> makeLongNets(int width) {
+    std::vector<Net> nets;
+    for (int i = 0; i < 20; ++i) {
+        Net net;
+        net.id = i;
+        net.name = "long" + std::to_string(i);
+        net.driver = (10 + i * 8) * width + 5;
+        net.sinks = {(width - 10 - i * 8) * width + (width - 6)};
+        nets.push_back(net);
+    }
+    return nets;
+}
+
+static void benchEdgeScaling() {
+    const int width = 64;
+    const int num_nets = 200;
+    
+    std::vector<Net> nets;
+    for (int i = 0; i < num_nets; ++i) {
+        Net net;
+        net.id = i;
+        net.name = "n" + std::to_string(i);
+        int x = i % 8, y = (i / 8) % 8;
+        net.driver = y * width + x;
+        net.sinks = {(y + 3) * width + (x + 3)};
+        nets.push_back(net);
+    }
+    
+    std::cout << std::setw(12) << "edges" << std::setw(16) << "us/net" << "\n";
+    for (int extra : {0, 100000, 400000, 1600000}) {
+        RoutingGraph graph = makeGridGraph(width, extra);
+        
+        // Uma única passada: mede a busca, não a negociação de congestionamento.
+        // Sem A*: o pré-cálculo do lookahead percorre o grafo todo e mascararia o custo por net
+        RouterOptions options;
+        options.max_iterations = 1;
+        options.astar_fac = 0.0f;
+        Router router(options);
+        auto start = std::chrono::steady_clock::now();
+        auto routes = routeQuiet(router, graph, nets);
+        auto end = std::chrono::steady_clock::now();
+        
+        double us = std::chrono::duration<double, std::micro>(end - start).count();
+        std::cout << std::setw(12) << graph.numEdges()
+                  << std::setw(16) << std::fixed << std::setprecision(2)
+                  << us / routes.size() << "\n";
+    }
+}
+
+static void benchAStar() {
+    const int width = 192;
+    RoutingGraph graph = makeGridGraph(width, 0);
+    std::vector<Net> nets = makeLongNets(width);
+    
+    std::cout << "\n" << std::setw(12) << "astar_fac" << std::setw(16) << "pushes/conn"
+              << std::setw(16) << "expanded/conn" << "\n";
+    for (float astar_fac : {0.0f, 1.0f, 1.2f}) {
+        RouterOptions options;
+        options.max_iterations = 1;
+        options.astar_fac = astar_fac;
+        Router router(options);
+        routeQuiet(router, graph, nets);
+        
+        const RouterStats& stats = router.stats();
+        std::cout << std::setw(12) << std::setprecision(1) << astar_fac
+                  << std::setw(16) << stats.heap_pushes / stats.connections
+                  << std::setw(16) << stats.nodes_expanded / stats.connections << "\n";
+    }
+}
+
+static void benchGraphBuild() {
+    auto arch = loadBenchArch();
+    if (arch.tiles.empty()) {
+        std::cout << "\nArquitetura não encontrada, pulando construção do grafo\n";
+        return;
+    }
+    
+    const int size = 120;
+    std::cout << "\n" << std::setw(12) << "threads" << std::setw(16) << "build ms"
+              << std::setw(16) << "edges" << "\n";
+    for (int threads : {1, 2, 4}) {
+        GraphBuildOptions options;
+        options.num_threads = threads;
+        RoutingGraphBuilder builder(options);
+        
+        RoutingGraph graph;
+        auto start = std::chrono::steady_clock::now();
+        {
+            QuietOutput quiet;
+            graph = builder.buildGraph(arch, size, size);
+        }
+        auto end = std::chrono::steady_clock::now();
+        
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::setw(12) << threads
+                  << std::setw(16) << std::fixed << std::setprecision(1) << ms
+                  << std::setw(16) << graph.numEdges() << "\n";
+    }
+}
+
+// Netlist empacotada sintética no formato do VPR: num_inputs pads de
+// entrada, num_clbs clusters com 40 entradas e hierarquia interna, e um
+// pad de saída por cluster
+static void writeSyntheticNetFile(const std::string& filename, int num_inputs, int num_clbs) {
+    std::ofstream out(filename);
+    std::mt19937 rng(7);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<block name=\"synthetic.net\" instance=\"FPGA_packed_netlist[0]\">\n"
+        << "\t<inputs></inputs>\n\t<outputs></outputs>\n\t<clocks></clocks>\n";
+    
+    auto netName = [&](int i) {
+        return i < num_inputs ? "in" + std::to_string(i) : "n" + std::to_string(i - num_inputs);
+    };
+    for (int c = 0; c < num_clbs; ++c) {
+        out << "\t<block name=\"n" << c << "\" instance=\"clb[" << c << "]\" mode=\"default\">\n"
+            << "\t\t<inputs>\n\t\t\t<port name=\"I\">";
+        for (int i = 0; i < 40; ++i) {
+            bool used = i < 6 && (c > 0 || i < 2);
+            out << (i ? " " : "") << (used ? netName(rng() % (num_inputs + c)) : "open");
+        }
+        out << "</port>\n\t\t</inputs>\n\t\t<outputs>\n\t\t\t<port name=\"O\">";
+        for (int i = 0; i < 19; ++i) out << "open ";
+        out << "fle[0].out[0]-&gt;clbouts1</port>\n\t\t</outputs>\n"
+            << "\t\t<clocks>\n\t\t\t<port name=\"clk\">open</port>\n\t\t</clocks>\n"
+            << "\t\t<block name=\"n" << c << "\" instance=\"fle[0]\" mode=\"n1_lut6\">\n"
+            << "\t\t\t<inputs>\n\t\t\t\t<port name=\"in\">clb.I[0]-&gt;crossbar clb.I[1]-&gt;crossbar "
+            << "clb.I[2]-&gt;crossbar clb.I[3]-&gt;crossbar clb.I[4]-&gt;crossbar clb.I[5]-&gt;crossbar</port>\n"
+            << "\t\t\t</inputs>\n\t\t\t<outputs>\n\t\t\t\t<port name=\"out\">n" << c << " open</port>\n"
+            << "\t\t\t</outputs>\n\t\t</block>\n";
+        for (int f = 1; f < 10; ++f) {
+            out << "\t\t<block name=\"open\" instance=\"fle[" << f << "]\" />\n";
+        }
+        out << "\t</block>\n";
+    }
+    for (int i = 0; i < num_inputs; ++i) {
+        out << "\t<block name=\"in" << i << "\" instance=\"io[" << i << "]\" mode=\"inpad\">\n"
+            << "\t\t<inputs>\n\t\t\t<port name=\"outpad\">open</port>\n\t\t</inputs>\n"
+            << "\t\t<outputs>\n\t\t\t<port name=\"inpad\">inpad[0].inpad[0]-&gt;inpad</port>\n\t\t</outputs>\n"
+            << "\t\t<block name=\"in" << i << "\" instance=\"inpad[0]\">\n"
+            << "\t\t\t<outputs>\n\t\t\t\t<port name=\"inpad\">in" << i << "</port>\n\t\t\t</outputs>\n"
+            << "\t\t</block>\n\t</block>\n";
+    }
+    for (int c = 0; c < num_clbs; ++c) {
+        out << "\t<block name=\"out:n" << c << "\" instance=\"io[" << num_inputs + c << "]\" mode=\"outpad\">\n"
+            << "\t\t<inputs>\n\t\t\t<port name=\"outpad\">n" << c << "</port>\n\t\t</inputs>\n"
+            << "\t</block>\n";
+    }
+    out << "</block>\n";
+}
+
+static void benchNetParse() {
+    const std::string filename = benchTempPath("bench_synthetic.net");
+    const int num_clbs = 50000;
+    writeSyntheticNetFile(filename, 1000, num_clbs);
+    double megabytes = 0.0;
+    {
+        std::ifstream in(filename, std::ios::binary | std::ios::ate);
+        megabytes = static_cast<double>(in.tellg()) / (1024.0 * 1024.0);
+    }
+    
+    std::cout << "\n.net sintético: " << num_clbs << " clusters, "
+              << std::fixed << std::setprecision(1) << megabytes << " MB\n"
+              << std::setw(12) << "parser" << std::setw(16) << "ms"
+              << std::setw(16) << "MB/s" << std::setw(16) << "nets" << "\n";
+    
+    // DOM: leitura original, nets por bloco
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Net> dom_nets = read_net_file_dom(filename);
+    auto end = std::chrono::steady_clock::now();
+    double dom_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    // Streaming: mesma varredura, resolvendo cada net até os pinos dos clusters
+    start = std::chrono::steady_clock::now();
+    PackedNetlist netlist = read_packed_netlist(filename);
+    end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    size_t terminals = 0;
+    for (const auto& net : netlist.nets) terminals += net.sinks.size() + (net.driver.block >= 0);
+    
+    std::cout << std::setw(12) << "streaming"
+              << std::setw(16) << std::setprecision(1) << ms
+              << std::setw(16) << megabytes / (ms / 1000.0)
+              << std::setw(16) << netlist.nets.size()
+              << "  (" << terminals << " terminais)\n";
+    std::cout << std::setw(12) << "DOM"
+              << std::setw(16) << std::setprecision(1) << dom_ms
+              << std::setw(16) << megabytes / (dom_ms / 1000.0)
+              << std::setw(16) << dom_nets.size() << "\n";
+    
+    // Os dois modelos nomeiam as nets pelo sinal: os nomes devem coincidir
+    std::vector<std::string> dom_names, packed_names;
+    for (const auto& net : dom_nets) dom_names.push_back(net.name);
+    for (const auto& net : netlist.nets) packed_names.push_back(net.name);
+    std::sort(dom_names.begin(), dom_names.end());
+    std::sort(packed_names.begin(), packed_names.end());
+    std::cout << "mesmas nets: " << (dom_names == packed_names ? "sim" : "NÃO") << "\n";
+    std::remove(filename.c_str());
+}
+
+static void benchTerminalMapping() {
+    auto arch = loadBenchArch();
+    if (arch.tiles.empty()) return;
+    
+    const int size = 100;
+    RoutingGraphBuilder builder;
+    RoutingGraph graph;
+    {
+        QuietOutput quiet;
+        graph = builder.buildGraph(arch, size, size);
+    }
+    
+    // Um bloco por célula interna; nets com driver em O e 4 sinks em I
+    PackedNetlist netlist;
+    netlist.block_types.push_back("clb");
+    netlist.port_names = {"I", "O"};
+    std::vector<Placement> placements;
+    for (int y = 1; y < size - 1; ++y) {
+        for (int x = 1; x < size - 1; ++x) {
+            std::string name = "b" + std::to_string(netlist.blocks.size());
+            placements.push_back({name, x, y, 0, static_cast<int>(netlist.blocks.size()), ""});
+            netlist.blocks.push_back({name, 0, "default"});
+        }
+    }
+    std::mt19937 rng(11);
+    const int num_blocks = static_cast<int>(netlist.blocks.size());
+    
+    std::cout << "\n" << std::setw(12) << "nets" << std::setw(16) << "terminais"
+              << std::setw(16) << "ms" << std::setw(16) << "Mterm/s" << "\n";
+    for (int num_nets : {100000, 200000, 400000}) {
+        netlist.nets.assign(num_nets, PackedNet());
+        for (auto& net : netlist.nets) {
+            net.driver = {static_cast<int>(rng() % num_blocks), 1, static_cast<int>(rng() % 20)};
+            for (int s = 0; s < 4; ++s) {
+                net.sinks.push_back({static_cast<int>(rng() % num_blocks), 0, static_cast<int>(rng() % 40)});
+            }
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        TerminalMap terminals = builder.mapTerminals(netlist, placements, arch);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << std::setw(12) << num_nets
+                  << std::setw(16) << terminals.class_node.size()
+                  << std::setw(16) << std::setprecision(1) << ms
+                  << std::setw(16) << terminals.class_node.size() / (ms * 1000.0) << "\n";
+    }
+}
+
+// Árvore estrela: fonte e um fio por sink, com R/C variando por variant
+static RouteTree makeStarTree(int num_sinks, int variant) {
+    RouteTree tree;
+    tree.addNode(0, -1, 0.0f);
+    for (int k = 0; k < num_sinks; ++k) {
+        tree.sink_branches.push_back(tree.addNode(1 + (variant + k) % 7, 0, 0.0f, 0));
+    }
+    tree.routed = true;
+    return tree;
+}
+
+static void benchTiming() {
+    auto arch = loadBenchArch();
+    if (arch.switches.empty()) return;
+    
+    // Oito nós com R/C distintos bastam para as árvores sintéticas
+    RoutingGraph graph;
+    graph.nodes.resize(8);
+    for (int i = 1; i < 8; ++i) {
+        graph.nodes.rc_index[i] = static_cast<uint16_t>(graph.nodes.internRC(50.0f * i, 2e-14f * i));
+    }
+    
+    std::cout << "\n" << std::setw(12) << "blocos" << std::setw(16) << "conexões"
+              << std::setw(16) << "completa ms" << std::setw(16) << "1% ms" << "\n";
+    std::mt19937 rng(5);
+    for (int num_blocks : {10000, 50000, 200000}) {
+        // 10% de io; cada net liga um bloco a 4 blocos sorteados
+        PackedNetlist netlist;
+        netlist.block_types = {"io", "clb"};
+        for (int b = 0; b < num_blocks; ++b) {
+            netlist.blocks.push_back({"b" + std::to_string(b), b % 10 == 0 ? 0 : 1, "default"});
+        }
+        std::vector<Net> nets(num_blocks);
+        for (int n = 0; n < num_blocks; ++n) {
+            nets[n].id = n;
+            nets[n].driver = 0;
+            nets[n].driver_block = n;
+            for (int k = 0; k < 4; ++k) {
+                nets[n].sinks.push_back(0);
+                nets[n].sink_blocks.push_back(static_cast<int>(rng() % num_blocks));
+            }
+        }
+        
+        TimingAnalyzer timing;
+        timing.build(arch, netlist, nets);
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < num_blocks; ++n) {
+            timing.updateNet(graph, n, makeStarTree(4, n));
+        }
+        timing.update();
+        double full_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        std::vector<int> variant(num_blocks);
+        for (int n = 0; n < num_blocks; ++n) variant[n] = n;
+        start = std::chrono::steady_clock::now();
+        for (int n = 0; n < num_blocks / 100; ++n) {
+            int net = static_cast<int>(rng() % num_blocks);
+            variant[net] = static_cast<int>(rng() % 8);
+            timing.updateNet(graph, net, makeStarTree(4, variant[net]));
+        }
+        timing.update();
+        double incremental_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        // Referência: análise completa sobre as mesmas árvores
+        TimingAnalyzer reference;
+        reference.build(arch, netlist, nets);
+        for (int n = 0; n < num_blocks; ++n) {
+            reference.updateNet(graph, n, makeStarTree(4, variant[n]));
+        }
+        reference.update();
+        bool same = reference.criticalPathDelay() == timing.criticalPathDelay();
+        
+        std::cout << std::setw(12) << num_blocks << std::setw(16) << num_blocks * 4
+                  << std::setw(16) << std::setprecision(1) << full_ms
+                  << std::setw(16) << incremental_ms << (same ? "" : "  ERRO") << "\n";
+    }
+}
+
+static void benchEco() {
+    const int width = 128;
+    const int cells = width / 8;
+    const int num_nets = cells * cells;
+    
+    // Uma net curta por célula 8x8: terminais nunca coincidem entre nets
+    std::mt19937 rng(3);
+    std::vector<Net> nets;
+    for (int i = 0; i < num_nets; ++i) {
+        Net net;
+        net.id = i;
+        net.name = "n" + std::to_string(i);
+        int x = (i % cells) * 8 + static_cast<int>(rng() % 3);
+        int y = (i / cells) * 8 + static_cast<int>(rng() % 3);
+        net.driver = y * width + x;
+        net.sinks = {(y + 3 + static_cast<int>(rng() % 3)) * width + (x + 3 + static_cast<int>(rng() % 3))};
+        nets.push_back(net);
+    }
+    
+    std::cout << "\n" << std::setw(12) << "alteradas" << std::setw(16) << "completo ms"
+              << std::setw(16) << "ECO ms" << std::setw(16) << "reroteadas" << "\n";
+    for (int num_changed : {1, 10, 100}) {
+        RoutingGraph graph = makeGridGraph(width, 0);
+        Router router;
+        auto start = std::chrono::steady_clock::now();
+        auto routes = routeQuiet(router, graph, nets);
+        double full_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        // Sinks de num_changed nets deslocados de uma coluna
+        std::vector<Net> eco_nets = nets;
+        for (int i = 0; i < num_changed; ++i) {
+            eco_nets[i * (num_nets / num_changed)].sinks[0] += 1;
+        }
+        
+        double eco_ms = 0.0;
+        {
+            QuietOutput quiet;
+            start = std::chrono::steady_clock::now();
+            EcoDiff diff = diff_nets(nets, eco_nets);
+            auto eco_routes = carry_over_routes(graph, routes, diff);
+            eco_routes = router.reroute(graph, eco_nets, std::move(eco_routes));
+            eco_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        
+        std::cout << std::setw(12) << num_changed
+                  << std::setw(16) << std::setprecision(1) << full_ms
+                  << std::setw(16) << eco_ms
+                  << std::setw(16) << router.stats().connections << "\n";
+    }
+}
+
+static void benchRouteFile() {
+    const int width = 1000;
+    RoutingGraph graph = makeGridGraph(width, 0);
+    
+    // 100k nets: caminho de 90 nós numa linha e um ramo de 10 nós saindo do meio
+    const int num_nets = 100000;
+    std::vector<Net> nets(num_nets);
+    std::vector<RouteTree> routes(num_nets);
+    long long total_nodes = 0;
+    for (int n = 0; n < num_nets; ++n) {
+        int y = n % (width - 10), x0 = (n / (width - 10)) * 9 % (width - 90);
+        Net& net = nets[n];
+        net.id = n;
+        net.name = "n" + std::to_string(n);
+        net.driver = y * width + x0;
+        
+        RouteTree& tree = routes[n];
+        tree.net_id = n;
+        tree.routed = true;
+        tree.total_delay = 0.0f;
+        int parent = tree.addNode(net.driver, -1, 0.0f);
+        for (int x = x0 + 1; x < x0 + 90; ++x) parent = tree.addNode(y * width + x, parent, 0.0f, 0);
+        tree.sink_branches.push_back(parent);
+        parent = 45;
+        for (int dy = 1; dy <= 10; ++dy) parent = tree.addNode((y + dy) * width + x0 + 45, parent, 0.0f, 0);
+        tree.sink_branches.push_back(parent);
+        net.sinks = {tree.nodes[tree.sink_branches[0]].rr_node, tree.nodes[parent].rr_node};
+        total_nodes += tree.nodes.size();
+    }
+    
+    std::cout << "\n" << std::setw(12) << "formato" << std::setw(16) << "nós"
+              << std::setw(16) << "MB" << std::setw(16) << "escrita ms" << std::setw(16) << "leitura ms" << "\n";
+    for (bool binary : {false, true}) {
+        std::string filename = benchTempPath(binary ? "bench_routes.bin" : "bench_routes.route");
+        auto start = std::chrono::steady_clock::now();
+        bool ok = binary ? write_route_binary(filename, nets, routes)
+                         : write_route_file(filename, graph, nets, routes, RouteFileInfo());
+        double write_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        auto loaded = binary ? read_route_binary(filename, graph, nets)
+                             : read_route_file(filename, graph, nets);
+        double read_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        double megabytes = file.tellg() / (1024.0 * 1024.0);
+        bool same = ok && loaded.size() == routes.size() &&
+                    loaded.back().nodes.size() == routes.back().nodes.size() && loaded.back().routed;
+        std::cout << std::setw(12) << (binary ? "binário" : "texto") << std::setw(16) << total_nodes
+                  << std::setw(16) << std::setprecision(1) << megabytes
+                  << std::setw(16) << write_ms << std::setw(16) << read_ms
+                  << (same ? "" : "  ERRO") << "\n";
+        std::remove(filename.c_str());
+    }
+}
+
+// Mesmas conexões roteadas com cada backend da fila: tempo e entradas
+// descartadas por conexão
+static void benchQueues() {
+    struct Case {
+        const char* name;
+        RoutingGraph graph;
+        std::vector<Net> nets;
+    };
+    std::vector<Case> cases;
+    
+    const int width = 192;
+    cases.push_back({"grid", makeGridGraph(width, 0), makeLongNets(width)});
+    
+    // RR graph real: conexões de OPINs para IPINs sorteados
+    auto arch = loadBenchArch();
+    if (!arch.tiles.empty()) {
+        RoutingGraphBuilder builder;
+        Case real{"k6 60x60", {}, {}};
+        {
+            QuietOutput quiet;
+            real.graph = builder.buildGraph(arch, 60, 60);
+        }
+        
+        std::vector<int> opins, ipins;
+        for (size_t id = 0; id < real.graph.nodes.size(); ++id) {
+            if (real.graph.nodes.type(id) == RRNodeType::OPIN) opins.push_back(id);
+            if (real.graph.nodes.type(id) == RRNodeType::IPIN) ipins.push_back(id);
+        }
+        std::mt19937 rng(11);
+        for (int i = 0; i < 200; ++i) {
+            Net net;
+            net.id = i;
+            net.name = "r" + std::to_string(i);
+            net.driver = opins[rng() % opins.size()];
+            net.sinks = {ipins[rng() % ipins.size()]};
+            real.nets.push_back(net);
+        }
+        cases.push_back(std::move(real));
+    }
+    
+    std::cout << "\n" << std::setw(12) << "grafo" << std::setw(12) << "fila"
+              << std::setw(16) << "us/conn" << std::setw(16) << "pops/conn"
+              << std::setw(16) << "stale/conn" << "\n";
+    for (auto& c : cases) {
+        for (QueueKind queue : {QueueKind::BINARY_HEAP, QueueKind::FOUR_ARY_HEAP, QueueKind::RADIX}) {
+            RouterOptions options;
+            options.max_iterations = 1;
+            options.queue = queue;
+            options.log_nets = false;
+            Router router(options);
+            routeQuiet(router, c.graph, c.nets);  // Aquece lookahead e workspace
+            
+            auto start = std::chrono::steady_clock::now();
+            routeQuiet(router, c.graph, c.nets);
+            double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            
+            const RouterStats& stats = router.stats();
+            long long connections = std::max(1LL, stats.connections);
+            std::cout << std::setw(12) << c.name << std::setw(12) << queue_kind_name(queue)
+                      << std::setw(16) << std::setprecision(1) << us / connections
+                      << std::setw(16) << stats.heap_pops / connections
+                      << std::setw(16) << stats.stale_pops / connections << "\n";
+        }
+    }
+}
+
+// Conexões que atravessam o dispositivo: nós expandidos e tempo com a
+// busca só a partir da fonte e com as duas frentes
+static void benchBidirectional() {
+    const int width = 192;
+    RoutingGraph grid = makeGridGraph(width, 0);
+    std::vector<Net> grid_nets = makeLongNets(width);
+    
+    // RR graph real: OPINs de um canto para IPINs do canto oposto
+    auto arch = loadBenchArch();
+    RoutingGraph real;
+    std::vector<Net> real_nets;
+    if (!arch.tiles.empty()) {
+        RoutingGraphBuilder builder;
+        {
+            QuietOutput quiet;
+            real = builder.buildGraph(arch, 60, 60);
+        }
+        
+        std::vector<int> near, far;
+        for (size_t id = 0; id < real.nodes.size(); ++id) {
+            int x = real.nodes.x_low[id], y = real.nodes.y_low[id];
+            if (real.nodes.type(id) == RRNodeType::OPIN && x < 15 && y < 15) near.push_back(id);
+            if (real.nodes.type(id) == RRNodeType::IPIN && x > 45 && y > 45) far.push_back(id);
+        }
+        std::mt19937 rng(5);
+        for (int i = 0; i < 100 && !near.empty() && !far.empty(); ++i) {
+            Net net;
+            net.id = i;
+            net.name = "r" + std::to_string(i);
+            net.driver = near[rng() % near.size()];
+            net.sinks = {far[rng() % far.size()]};
+            real_nets.push_back(net);
+        }
+    }
+    
+    std::cout << "\n" << std::setw(12) << "grafo" << std::setw(12) << "astar_fac"
+              << std::setw(12) << "busca" << std::setw(16) << "expanded/conn"
+              << std::setw(16) << "us/conn" << std::setw(16) << "delay médio" << "\n";
+    for (int g = 0; g < 2; ++g) {
+        RoutingGraph& graph = g == 0 ? grid : real;
+        const std::vector<Net>& nets = g == 0 ? grid_nets : real_nets;
+        if (nets.empty()) continue;
+        for (float astar_fac : {0.0f, 1.2f}) {
+            for (int bidir_min_span : {0, 1}) {
+                if (astar_fac > 0.0f && bidir_min_span) continue;  // Cai na unidirecional
+                RouterOptions options;
+                options.max_iterations = 1;
+                options.astar_fac = astar_fac;
+                options.bidir_min_span = bidir_min_span;
+                options.log_nets = false;
+                Router router(options);
+                routeQuiet(router, graph, nets);  // Aquece lookahead e workspace
+                
+                auto start = std::chrono::steady_clock::now();
+                auto routes = routeQuiet(router, graph, nets);
+                double us = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - start).count();
+                
+                double delay = 0.0;
+                for (const auto& route : routes) delay += route.total_delay;
+                const RouterStats& stats = router.stats();
+                long long connections = std::max(1LL, stats.connections);
+                std::cout << std::setw(12) << (g == 0 ? "grid" : "k6 60x60")
+                          << std::setw(12) << std::setprecision(1) << astar_fac
+                          << std::setw(12) << (bidir_min_span ? "bidir" : "uni")
+                          << std::setw(16) << stats.nodes_expanded / connections
+                          << std::setw(16) << us / connections
+                          << std::setw(16) << std::setprecision(3) << delay / routes.size() << "\n";
+            }
+        }
+    }
+}
+
+static void benchOccupancy() {
+    const size_t num_nodes = 10000000;
+    RRNodeStore nodes;
+    nodes.resize(num_nodes);
+    std::fill(nodes.capacity.begin(), nodes.capacity.end(), 1);
+    RROccupancy occupancy;
+    occupancy.init(nodes);
+    
+    // 10k árvores de 20 nós sorteados: poucos nós passam da capacidade,
+    // como nas iterações finais da negociação
+    std::mt19937 rng(3);
+    std::vector<RouteTree> trees(10000);
+    for (auto& tree : trees) {
+        for (int i = 0; i < 20; ++i) tree.addNode(rng() % num_nodes, i - 1, 0.0f);
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& tree : trees) occupancy.commit(tree);
+    double commit_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    start = std::chrono::steady_clock::now();
+    OveruseSummary summary = occupancy.summary();
+    double summary_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    // Referência: varrer todos os nós como o laço antigo do PathFinder
+    start = std::chrono::steady_clock::now();
+    long long scanned = 0;
+    for (size_t id = 0; id < num_nodes; ++id) scanned += occupancy.overuse(id);
+    double scan_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    start = std::chrono::steady_clock::now();
+    occupancy.reset();
+    double reset_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    std::vector<int> plain(num_nodes, 1);
+    start = std::chrono::steady_clock::now();
+    std::fill(plain.begin(), plain.end(), 0);
+    double fill_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "\n" << std::setw(12) << "nós" << std::setw(16) << "sobreusados"
+              << std::setw(16) << "commit ms" << std::setw(16) << "resumo ms"
+              << std::setw(16) << "varredura ms" << std::setw(16) << "reset us"
+              << std::setw(16) << "fill us" << "\n";
+    std::cout << std::setw(12) << num_nodes << std::setw(16) << summary.nodes.size()
+              << std::setw(16) << std::setprecision(1) << commit_ms
+              << std::setw(16) << std::setprecision(3) << summary_ms
+              << std::setw(16) << std::setprecision(1) << scan_ms
+              << std::setw(16) << reset_us << std::setw(16) << fill_us
+              << (scanned == summary.total_overuse ? "" : "  ERRO") << "\n";
+}
+
+static void benchArchitectureCache() {
+    const std::string arch_file = BENCH_ARCH_FILE;
+    const std::string cache_dir = benchTempPath("arch_bench_cache");
+    std::ifstream in(arch_file, std::ios::binary);
+    if (!in) {
+        std::cout << "\nArquitetura não encontrada, pulando cache da arquitetura\n";
+        return;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::filesystem::remove_all(cache_dir);
+    
+    const int reps = 50;
+    auto start = std::chrono::steady_clock::now();
+    FPGAArchitecture parsed;
+    for (int i = 0; i < reps; ++i) parsed = parse_architecture_xml(arch_file);
+    double parse_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / reps;
+    
+    load_architecture(arch_file, cache_dir);  // Grava o cache
+    start = std::chrono::steady_clock::now();
+    FPGAArchitecture cached;
+    for (int i = 0; i < reps; ++i) cached = load_architecture(arch_file, cache_dir);
+    double cached_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / reps;
+    
+    bool same = cached.switches.size() == parsed.switches.size() &&
+                cached.segments.size() == parsed.segments.size() &&
+                cached.directs.size() == parsed.directs.size() &&
+                cached.tiles.size() == parsed.tiles.size() &&
+                cached.layout.rules.size() == parsed.layout.rules.size();
+    for (size_t t = 0; same && t < parsed.tiles.size(); ++t) {
+        same = cached.tiles[t].name == parsed.tiles[t].name &&
+               cached.tiles[t].ports.size() == parsed.tiles[t].ports.size();
+    }
+    
+    std::cout << "\n" << std::setw(16) << "XML us" << std::setw(16) << "cache us"
+              << std::setw(12) << "speedup" << std::setw(12) << "directs" << "\n";
+    std::cout << std::setw(16) << std::fixed << std::setprecision(1) << parse_us
+              << std::setw(16) << cached_us
+              << std::setw(12) << parse_us / cached_us
+              << std::setw(12) << cached.directs.size() << (same ? "" : "  ERRO") << "\n";
+    
+    // Varredura: 32 variantes (hash diferente) parseadas em lote, sem cache
+    std::vector<std::string> variants;
+    for (int v = 0; v < 32; ++v) {
+        std::string name = cache_dir + "/variant_" + std::to_string(v) + ".xml";
+        std::ofstream(name) << text << "<!-- variante " << v << " -->\n";
+        variants.push_back(name);
+    }
+    std::cout << std::setw(16) << "threads" << std::setw(16) << "lote ms"
+              << std::setw(16) << "ms/arquivo" << "\n";
+    for (int threads : {1, 2, 4}) {
+        start = std::chrono::steady_clock::now();
+        auto archs = load_architectures(variants, "", threads);
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        bool ok = std::all_of(archs.begin(), archs.end(), [&](const FPGAArchitecture& arch) {
+            return arch.directs.size() == parsed.directs.size();
+        });
+        std::cout << std::setw(16) << threads << std::setw(16) << std::setprecision(1) << ms
+                  << std::setw(16) << std::setprecision(2) << ms / variants.size()
+                  << (ok ? "" : "  ERRO") << "\n";
+    }
+    std::filesystem::remove_all(cache_dir);
+}
+
+int main() {
+    benchEdgeScaling();
+    benchAStar();
+    benchGraphBuild();
+    benchNetParse();
+    benchTerminalMapping();
+    benchTiming();
+    benchEco();
+    benchRouteFile();
+    benchQueues();
+    benchBidirectional();
+    benchOccupancy();
+    benchArchitectureCache();
+    
+    std::error_code error;
+    std::filesystem::remove_all(benchTempDir(), error);
+    return 0;
+}
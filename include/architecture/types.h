@@ -26,15 +26,28 @@ struct Port {
     std::string name, type;
     int num_pins;
     bool is_clock;
+    bool equivalent;  // Pinos logicamente equivalentes (equivalent="full")
 };
 
 struct Tile {
     std::string name, type;
-    int height;
+    int height, capacity;
     double area, fc_in, fc_out;
     std::vector<Port> ports;
 };
 
+// Regra do <auto_layout>: perimeter, corners, fill, col, row ou single
+struct GridRule {
+    std::string kind, type;
+    int priority;
+    int startx, starty, repeatx, repeaty;
+};
+
+struct Layout {
+    double aspect_ratio;
+    std::vector<GridRule> rules;
+};
+
 struct Device {
     double R_minW_nmos, R_minW_pmos, grid_logic_tile_area;
     std::string switch_block_type, connection_block_switch;
@@ -47,6 +60,7 @@ struct FPGAArchitecture {
     std::vector<Segment> segments;
     std::vector<Direct> directs;
     std::vector<Tile> tiles;
+    Layout layout;
 };
 
 #endif
\ No newline at end of file
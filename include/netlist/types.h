@@ -9,6 +9,37 @@ struct Net {
     std::string name;
     int driver;
     std::vector<int> sinks;
+    int driver_block = -1;         // Bloco do netlist do driver (-1 = desconhecido)
+    std::vector<int> sink_blocks;  // Bloco de cada sink, paralelo a sinks
+};
+
+// Terminal de uma net no nível do cluster: pino pin da porta port do bloco
+struct NetPin {
+    int block;  // Índice em PackedNetlist::blocks (-1 = sem terminal)
+    int port;   // Índice em PackedNetlist::port_names
+    int pin;
+};
+
+// Cluster do netlist empacotado
+struct PackedBlock {
+    std::string name;
+    int type;          // Índice em PackedNetlist::block_types ("clb", "io", ...)
+    std::string mode;
+};
+
+struct PackedNet {
+    std::string name;
+    NetPin driver;
+    std::vector<NetPin> sinks;
+};
+
+// Netlist hierárquico resolvido até os pinos dos clusters. Blocos, portas,
+// tipos e nets são referenciados por índices compactos
+struct PackedNetlist {
+    std::vector<PackedBlock> blocks;
+    std::vector<std::string> block_types;
+    std::vector<std::string> port_names;
+    std::vector<PackedNet> nets;
 };
 
 #endif 
\ No newline at end of file
@@ -5,7 +5,8 @@
 
 struct Placement {
     std::string block_name;
-    int x, y, subblock, block_num;
+    int x, y, subblock;
+    int block_num;  // Índice do bloco no netlist ("#N"); -1 se ausente
     std::string pin_name;
 };
 
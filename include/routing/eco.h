@@ -0,0 +1,29 @@
+#ifndef ROUTING_ECO_H
+#define ROUTING_ECO_H
+
+#include "./types.h"
+#include "../netlist/types.h"
+#include <vector>
+
+// Diferença entre duas versões das nets físicas (mesmo RR graph). Nets são
+// casadas por nome; uma net muda quando o driver ou algum sink muda de nó,
+// seja por edição do netlist ou por bloco movido no placement
+struct EcoDiff {
+    std::vector<int> new_to_old;  // Net nova -> net anterior (-1 = nova)
+    std::vector<char> changed;    // Net nova precisa de rota nova
+    std::vector<int> removed;     // Nets anteriores sem correspondente
+    int num_changed = 0;
+};
+
+EcoDiff diff_nets(const std::vector<Net>& old_nets, const std::vector<Net>& new_nets);
+
+// Rotas da nova versão: as árvores das nets inalteradas são movidas de
+// old_routes, e a ocupação das removidas e alteradas é retirada do grafo
+// (que deve refletir old_routes). As nets alteradas ficam sem rota
+std::vector<RouteTree> carry_over_routes(RoutingGraph& graph, std::vector<RouteTree>& old_routes,
+                                         const EcoDiff& diff);
+
+// Soma a ocupação das rotas ao grafo (rotas carregadas de arquivo)
+void apply_route_occupancy(RoutingGraph& graph, const std::vector<RouteTree>& routes);
+
+#endif
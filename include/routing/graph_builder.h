@@ -5,65 +5,180 @@
 #include "netlist/types.h"
 #include "placement/types.h"
 #include "routing/types.h"
+#include <cstdint>
+#include <string>
 #include <vector>
-#include <map>
+
+// Parâmetros da geração do grafo
+struct GraphBuildOptions {
+    int channel_width = 60;  // Trilhas por canal (W)
+    int grid_width = 0;      // 0 = derivar do placement
+    int grid_height = 0;
+    int num_threads = 1;     // > 1 gera faixas de linhas do grid em paralelo
+    std::string cache_dir;   // Diretório do cache binário do grafo ("" = desativado)
+    uint64_t arch_hash = 0;  // hash_architecture_text do XML, chave do cache (0 = sem cache)
+};
+
+// Célula do grid: tipo de tile (-1 = EMPTY) e linha relativa à raiz
+// (tiles com height > 1 ocupam várias células)
+struct GridCell {
+    int tile;
+    int y_offset;
+};
+
+// Trilha de um canal: segmento, comprimento, direção e deslocamento dos fios
+struct TrackInfo {
+    int segment;
+    int length;
+    int offset;
+    int direction;  // 1 = INC, -1 = DEC, 0 = bidirecional
+};
+
+// Layout dos nós de um tipo de tile. Cada instância (sub_tile) tem primeiro
+// os pinos de todas as portas, depois as classes (SOURCE/SINK): uma por
+// porta equivalente ou uma por pino
+struct TileTemplate {
+    std::vector<int> port_pin_offset;
+    std::vector<int> port_class_offset;
+    std::vector<int> node_names;  // Nome internado de cada nó da instância
+    int nodes_per_instance;
+    int num_nodes;
+};
+
+// Terminais do netlist no RR graph, em vetores planos por net: a net n
+// ocupa [net_begin[n], net_begin[n + 1]), com o driver primeiro. Nós são -1
+// quando o terminal não existe ou o bloco não foi posicionado
+struct TerminalMap {
+    std::vector<int> net_begin;
+    std::vector<int> class_node;  // SOURCE/SINK
+    std::vector<int> pin_node;    // OPIN/IPIN
+};
 
 class RoutingGraphBuilder {
 public:
     RoutingGraphBuilder() = default;
-    
-    // Constrói o grafo de roteamento completo
+    explicit RoutingGraphBuilder(const GraphBuildOptions& options) : options_(options) {}
+
+    // Constrói o grafo de roteamento completo; o grid sai do placement,
+    // ajustado ao aspect_ratio da arquitetura, quando as opções não o fixam
     RoutingGraph buildGraph(
         const FPGAArchitecture& arch,
-        const std::vector<Net>& nets,
         const std::vector<Placement>& placements
     );
+    
+    // Constrói o grafo para um grid de dimensões fixas
+    RoutingGraph buildGraph(
+        const FPGAArchitecture& arch,
+        int grid_width,
+        int grid_height
+    );
 
+    // Localiza os terminais pelo placement (x, y, subblock) em tempo linear:
+    // cada bloco resolve o seu primeiro nó uma vez e cada terminal soma o
+    // deslocamento do pino no template do tile
+    TerminalMap mapTerminals(
+        const PackedNetlist& netlist,
+        const std::vector<Placement>& placements,
+        const FPGAArchitecture& arch
+    ) const;
+    
+    // Cada terminal (bloco, porta, pino) vira o SOURCE/SINK da classe do seu
+    // pino no tile onde o bloco foi posicionado. Pinos de portas equivalentes
+    // caem na mesma classe, e sinks repetidos da net são unidos.
+    // physical_nets[i] corresponde a netlist.nets[i]
     void mapNetsToPhysicalNodes(
-        const std::vector<Net>& logical_nets,
+        const PackedNetlist& netlist,
         const std::vector<Placement>& placements,
         const FPGAArchitecture& arch,
         std::vector<Net>& physical_nets,
         RoutingGraph& graph
     );
-    
+
+    int gridWidth() const { return grid_width_; }
+    int gridHeight() const { return grid_height_; }
+
 private:
-    // Métodos auxiliares
+    // Aplica as regras do <auto_layout> em ordem de prioridade
+    void createGrid(const FPGAArchitecture& arch, int grid_width, int grid_height);
+
+    // Distribui as trilhas do canal entre os segmentos conforme freq
+    void createTracks(const FPGAArchitecture& arch);
+
+    // Quantidade de nós criados pela linha y (tiles com raiz nela e fios que começam nela)
+    int countRowNodes(int y) const;
+
+    // Nós dos pinos e classes de todas as instâncias do tile com raiz em (x, y),
+    // gravados em graph.nodes a partir de next_id
     void createTileNodes(
         const Tile& tile,
-        int x, 
+        int x,
         int y,
-        const FPGAArchitecture& arch,
-        RoutingGraph& graph
+        RoutingGraph& graph,
+        int& next_id
     );
-    
+
+    // Fios CHANX do canal y e fios CHANY que começam na linha y
     void createChannelNodes(
         const FPGAArchitecture& arch,
-        int grid_width,
-        int grid_height,
-        RoutingGraph& graph
+        int y,
+        RoutingGraph& graph,
+        int& next_id
     );
-    
+
+    // SOURCE->OPIN, OPIN->fios, fios->IPIN e IPIN->SINK dos tiles da linha y
+    void createPinConnections(
+        const FPGAArchitecture& arch,
+        const RoutingGraph& graph,
+        int y,
+        std::vector<RREdge>& edges
+    ) const;
+
+    // Switch blocks da linha y (fio->fio)
     void createSwitchConnections(
         const FPGAArchitecture& arch,
-        RoutingGraph& graph
-    );
-    
+        const RoutingGraph& graph,
+        int y,
+        std::vector<RREdge>& edges
+    ) const;
+
+    // Conexões diretas OPIN->IPIN entre tiles vizinhos
     void createDirectConnections(
         const FPGAArchitecture& arch,
-        RoutingGraph& graph
-    );
-    
-    void createTestNodes(
-        RoutingGraph& graph,
-        const std::vector<Net>& nets
-    );
+        std::vector<RREdge>& edges
+    ) const;
+
+    // Fio da trilha t que passa pela posição (x, y) do canal; -1 se o canal não existe
+    int chanxWire(int x, int y, int track) const;
+    int chanyWire(int x, int y, int track) const;
 
-    // Mapeamentos auxiliares
-    std::map<std::tuple<int, int, std::string, std::string>, int> pin_node_map_;  
-    // (x, y, tile_type, pin_name) -> node_id
+    // Lado do tile em que o pino fica (0 = TOP, 1 = RIGHT, 2 = BOTTOM, 3 = LEFT)
+    int pinSide(int x, int y, int pin) const;
+
+    // Nó do pino / da classe de uma porta de uma instância do tile com raiz em (x, y)
+    int pinNode(int x, int y, int z, int port, int pin) const;
+    int classNode(const FPGAArchitecture& arch, int x, int y, int z, int port, int pin) const;
+
+    // Instância do tile onde o bloco foi posicionado: raiz (x, y) e z
+    bool locateBlock(const FPGAArchitecture& arch, const Placement& placement, int& x, int& y, int& z) const;
+    
+    // Atraso (ns) de entrar num fio pelo switch sw
+    float wireEdgeDelay(const FPGAArchitecture& arch, int sw, int track) const;
 
-    std::map<std::string, int> tile_type_count_;
+    GraphBuildOptions options_;
+    int grid_width_ = 0;
+    int grid_height_ = 0;
+    int channel_width_ = 0;
+    std::vector<GridCell> grid_;               // grid_[y * W + x]
+    std::vector<TileTemplate> templates_;      // Um por tipo de tile
+    std::vector<TrackInfo> tracks_;            // Uma por trilha do canal
+    std::vector<int> segment_switch_;          // Switch do mux de cada segmento
+    int ipin_switch_ = -1;
+    int chanx_name_ = 0;
+    int chany_name_ = 0;
+    std::vector<std::vector<int>> wire_rc_;    // [segmento][comprimento - 1] -> índice em rc_data
+    std::vector<int> tile_base_;               // Primeiro nó do tile com raiz na célula (-1 se não houver)
+    std::vector<int> chanx_wire_;              // ((y * W + x) * Wc + t) -> nó do fio
+    std::vector<int> chany_wire_;
 };
 
-#endif 
\ No newline at end of file
+#endif
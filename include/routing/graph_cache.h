@@ -0,0 +1,31 @@
+#ifndef ROUTING_GRAPH_CACHE_H
+#define ROUTING_GRAPH_CACHE_H
+
+#include "routing/types.h"
+#include <cstdint>
+#include <string>
+
+// Versão do formato binário; incrementar a cada mudança de layout
+const uint32_t GRAPH_CACHE_VERSION = 3;
+
+// Identifica um grafo construído: conteúdo da arquitetura e dimensões
+struct GraphCacheKey {
+    uint64_t arch_hash;
+    int grid_width, grid_height, channel_width;
+};
+
+// Arquivo de cache da chave dentro de dir
+std::string graph_cache_path(const std::string& dir, const GraphCacheKey& key);
+
+// Grava um grafo congelado (escreve num temporário e renomeia)
+bool save_graph_cache(const std::string& filename, const RoutingGraph& graph,
+                      const GraphCacheKey& key);
+
+// Mapeia o arquivo com mmap: arrays dos nós, CSR e switches viram vistas sem
+// cópia (só a ocupação e as tabelas de nomes e de R/C são alocadas). Retorna false se
+// faltar o arquivo ou se versão/chave não baterem; graph só é alterado em
+// caso de sucesso
+bool load_graph_cache(const std::string& filename, const GraphCacheKey& key,
+                      RoutingGraph& graph);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef ROUTING_LOOKAHEAD_H
+#define ROUTING_LOOKAHEAD_H
+
+#include "./types.h"
+#include <vector>
+
+// Estimativa do custo restante até um alvo para o A*.
+// Tabela indexada por (tipo de nó, |dx|, |dy|), pré-calculada com
+// Dijkstra a partir de alguns nós amostrados de cada tipo.
+class RouterLookahead {
+public:
+    RouterLookahead() = default;
+    
+    // Amostra até samples_per_type nós de cada tipo (centro e cantos)
+    void build(const RoutingGraph& graph, int samples_per_type = 3);
+    
+    // Custo estimado de node_id até a posição (target_x, target_y)
+    float estimate(const RoutingGraph& graph, int node_id, int target_x, int target_y,
+                   float criticality) const {
+        const RRNodeStore& nodes = graph.nodes;
+        int dx = distance(target_x, nodes.x_low[node_id], nodes.x_high[node_id]);
+        int dy = distance(target_y, nodes.y_low[node_id], nodes.y_high[node_id]);
+        if (dx > max_dx_) dx = max_dx_;
+        if (dy > max_dy_) dy = max_dy_;
+        
+        const Entry& entry = table_[index(nodes.types[node_id], dx, dy)];
+        return criticality * entry.delay + (1.0f - criticality) * entry.cong;
+    }
+    
+    bool empty() const { return table_.empty(); }
+    
+private:
+    struct Entry {
+        float delay;  // Menor atraso observado
+        float cong;   // Menor custo base observado
+    };
+    
+    static int distance(int target, int low, int high) {
+        if (target < low) return low - target;
+        if (target > high) return target - high;
+        return 0;
+    }
+    
+    int index(int type, int dx, int dy) const {
+        return (type * (max_dy_ + 1) + dy) * (max_dx_ + 1) + dx;
+    }
+    
+    void sampleFrom(const RoutingGraph& graph, int source_id);
+    
+    int max_dx_ = 0;
+    int max_dy_ = 0;
+    std::vector<Entry> table_;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef ROUTING_OCCUPANCY_H
+#define ROUTING_OCCUPANCY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct RRNodeStore;
+struct RouteTree;
+
+// Sobreuso do grafo num instante
+struct OveruseSummary {
+    long long total_overuse = 0;  // Soma de max(0, uso - capacidade)
+    int max_overuse = 0;
+    std::vector<int> nodes;       // Nós sobreusados, em ordem de id
+};
+
+// Ocupação dos nós RR, fora dos dados somente-leitura do grafo. Um contador
+// atômico de 64 bits por nó guarda época, marca de "na lista de sobreuso" e
+// contagem, atualizados juntos por CAS: threads roteando ao mesmo tempo não
+// precisam de lock, e zerar tudo é trocar a época. O sobreuso total e o
+// número de nós sobreusados são mantidos a cada mudança; os nós que passam
+// da capacidade entram numa lista, e summary() evita varrer o grafo
+class RROccupancy {
+public:
+    RROccupancy() = default;
+    RROccupancy(RROccupancy&& other) noexcept { *this = std::move(other); }
+    RROccupancy& operator=(RROccupancy&& other) noexcept;
+
+    // Dimensiona para os nós (copia as capacidades) com ocupação zero
+    void init(const RRNodeStore& nodes);
+
+    size_t size() const { return size_; }
+
+    // Zera todas as ocupações em O(1)
+    void reset();
+
+    int used(int id) const {
+        uint64_t word = words_[id].load(std::memory_order_relaxed);
+        return (word >> EPOCH_SHIFT) == epoch_ ? static_cast<int>(static_cast<uint32_t>(word)) : 0;
+    }
+
+    int capacity(int id) const { return capacity_[id]; }
+    int overuse(int id) const { return std::max(0, used(id) - capacity_[id]); }
+
+    // Soma delta à ocupação do nó; seguro entre threads
+    void add(int id, int delta);
+
+    // Ocupa / libera todos os nós de uma árvore de roteamento
+    void commit(const RouteTree& tree);
+    void ripUp(const RouteTree& tree);
+
+    long long totalOveruse() const { return total_overuse_.load(std::memory_order_relaxed); }
+    int numOverused() const { return num_overused_.load(std::memory_order_relaxed); }
+
+    // Sobreuso atual em O(nós listados); compacta a lista, então não deve
+    // rodar junto com add()
+    OveruseSummary summary();
+
+private:
+    static const int EPOCH_SHIFT = 33;
+    static const uint64_t LISTED_BIT = uint64_t(1) << 32;
+    static const uint32_t MAX_EPOCH = (uint32_t(1) << 31) - 1;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    std::vector<uint16_t> capacity_;
+    std::unique_ptr<int[]> listed_;  // Nós que passaram da capacidade (cada um no máximo uma vez)
+    std::atomic<size_t> num_listed_{0};
+    std::atomic<long long> total_overuse_{0};
+    std::atomic<int> num_overused_{0};
+    size_t size_ = 0;
+    uint32_t epoch_ = 1;
+};
+
+#endif
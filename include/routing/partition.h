@@ -0,0 +1,41 @@
+#ifndef ROUTING_PARTITION_H
+#define ROUTING_PARTITION_H
+
+#include "./types.h"
+#include <vector>
+
+// Região do dispositivo na bisseção recursiva do grid
+struct PartitionRegion {
+    BoundingBox box;
+    int level;              // 0 = dispositivo inteiro
+    int children[2];        // -1 nas folhas
+    std::vector<int> nets;  // Nets contidas nesta região e em nenhuma filha
+};
+
+// Divide o grid por bisseção recursiva e distribui as nets pela região
+// mais profunda que contém sua caixa. Regiões de um mesmo nível são
+// disjuntas e podem ser roteadas em paralelo.
+class NetPartitioner {
+public:
+    NetPartitioner() = default;
+    
+    // Bisseção até max_level níveis, sempre cortando o lado mais longo
+    void build(const BoundingBox& device, int max_level);
+    
+    // Índices das nets por região (substitui a distribuição anterior)
+    void assign(const std::vector<BoundingBox>& net_boxes);
+    
+    const PartitionRegion& region(int index) const { return regions_[index]; }
+    int numLevels() const { return static_cast<int>(levels_.size()); }
+    
+    // Regiões do nível (0 = raiz)
+    const std::vector<int>& level(int level) const { return levels_[level]; }
+    
+private:
+    int split(const BoundingBox& box, int level, int max_level);
+    
+    std::vector<PartitionRegion> regions_;
+    std::vector<std::vector<int>> levels_;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef ROUTING_PROFILING_H
+#define ROUTING_PROFILING_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Instrumentação do caminho quente (contadores da busca e tempo por net).
+// Com ROUTER_PROFILING=0 (opção ENABLE_PROFILING=OFF do CMake) os macros
+// viram no-ops e nada é medido; os tempos de fase continuam disponíveis
+#ifndef ROUTER_PROFILING
+#define ROUTER_PROFILING 1
+#endif
+
+#if ROUTER_PROFILING
+#define PROFILE_COUNT(counter) ((counter)++)
+#define PROFILE_ADD(counter, value) ((counter) += (value))
+#else
+#define PROFILE_COUNT(counter) ((void)0)
+#define PROFILE_ADD(counter, value) ((void)0)
+#endif
+
+class Router;
+struct Net;
+
+// Tempo de uma fase do fluxo (parse, construção do grafo, roteamento...)
+struct PhaseTime {
+    std::string name;
+    double ms;
+};
+
+// Fases na ordem em que terminaram
+class Profiler {
+public:
+    void addPhase(const std::string& name, double ms) { phases_.push_back({name, ms}); }
+    const std::vector<PhaseTime>& phases() const { return phases_; }
+
+private:
+    std::vector<PhaseTime> phases_;
+};
+
+// Cronometra o escopo e registra a fase no destrutor
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler& profiler, const char* name)
+        : profiler_(profiler), name_(name), start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        profiler_.addPhase(name_, std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start_).count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Profiler& profiler_;
+    const char* name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Relatório JSON: fases, contadores da busca e tempo de roteamento por
+// net (nets[i] <-> router.netTimes()[i]). Retorna false se não gravar
+bool write_profile_report(
+    const std::string& filename,
+    const Profiler& profiler,
+    const Router& router,
+    const std::vector<Net>& nets
+);
+
+#endif
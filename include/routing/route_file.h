@@ -0,0 +1,52 @@
+#ifndef ROUTING_ROUTE_FILE_H
+#define ROUTING_ROUTE_FILE_H
+
+#include "./types.h"
+#include "../netlist/types.h"
+#include <string>
+#include <vector>
+
+// Cabeçalho do .route
+struct RouteFileInfo {
+    std::string placement_file;
+    std::string placement_id;  // Opcional ("" = omitido)
+    int grid_width = 0;
+    int grid_height = 0;
+};
+
+// Grava as rotas no formato .route do VPR: por net, o traceback dos nós
+// (cada ramo novo recomeça pelo nó da árvore onde se conecta), com o
+// switch usado para chegar ao nó seguinte
+bool write_route_file(
+    const std::string& filename,
+    const RoutingGraph& graph,
+    const std::vector<Net>& nets,
+    const std::vector<RouteTree>& routes,
+    const RouteFileInfo& info
+);
+
+// Lê um .route e reconstrói as árvores sobre o grafo: nets casadas pelo
+// índice e nome (ou só pelo nome), atrasos e switches recalculados pelas
+// arestas do grafo. result[i] corresponde a nets[i]; nets ausentes ficam
+// sem rota. Retorna vazio se o arquivo não abrir ou não bater com o grafo
+std::vector<RouteTree> read_route_file(
+    const std::string& filename,
+    const RoutingGraph& graph,
+    const std::vector<Net>& nets
+);
+
+// Variante binária compacta: por net, nome e nós com o id em delta
+// zigzag do anterior e o pai como distância até o nó, ambos em varint
+bool write_route_binary(
+    const std::string& filename,
+    const std::vector<Net>& nets,
+    const std::vector<RouteTree>& routes
+);
+
+std::vector<RouteTree> read_route_binary(
+    const std::string& filename,
+    const RoutingGraph& graph,
+    const std::vector<Net>& nets
+);
+
+#endif
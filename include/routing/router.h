@@ -2,28 +2,212 @@
 #define ROUTING_ROUTER_H
 
 #include "./types.h"
+#include "./lookahead.h"
+#include "./search_workspace.h"
+#include "./thread_pool.h"
+#include "./timing.h"
 #include "../netlist/types.h"
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+// Parâmetros do PathFinder (negotiated congestion)
+struct RouterOptions {
+    int max_iterations = 50;        // Limite de iterações de rip-up/reroute
+    float initial_pres_fac = 0.5f;  // Fator de congestionamento presente na 1a iteração
+    float pres_fac_mult = 1.3f;     // Crescimento do pres_fac por iteração
+    float max_pres_fac = 1000.0f;
+    float hist_fac = 1.0f;          // Peso do custo histórico acumulado
+    float criticality = 0.5f;       // Peso do atraso no custo (0 = só congestionamento)
+    float astar_fac = 1.2f;         // Peso do lookahead no A* (0 = Dijkstra puro)
+    int lookahead_samples = 3;      // Nós amostrados por tipo para o lookahead
+    int num_threads = 1;            // > 1 ativa o roteamento paralelo por regiões
+    int bb_margin = 3;              // Folga da caixa da net além dos terminais
+    bool log_nets = true;           // Linha por net no stdout (custa tempo em designs grandes)
+    QueueKind queue = QueueKind::FOUR_ARY_HEAP;  // Fila de prioridade da busca
+    float queue_resolution = 1e-3f; // Passo de quantização do custo (QueueKind::RADIX)
+    float reroute_criticality = 0.9f;  // Conexão legal com criticidade >= isto e atraso
+                                       // acima de reroute_delay_slack x o melhor já
+                                       // obtido também é refeita
+    float reroute_delay_slack = 1.1f;
+    int bidir_min_span = 0;         // Conexão fonte -> sink com |dx|+|dy| >= isto usa
+                                    // busca bidirecional (0 = desativada; só vale com
+                                    // astar_fac = 0, senão a busca é unidirecional)
+};
+
+// Estado de uma conexão (net, sink) entre iterações do PathFinder
+struct ConnectionState {
+    float delay = 0.0f;       // Atraso fonte -> sink na árvore atual: Elmore da STA
+                              // se houver analisador, senão a soma de nós e arestas
+    float best_delay = 0.0f;  // Menor atraso já obtido (0 = ainda não roteada)
+    float criticality = 0.0f; // Usada na última busca
+    bool legal = false;       // Caminho sem nós sobreusados (na última verificação)
+};
+
+// Limites da busca de uma net
+struct SearchBounds {
+    BoundingBox net_box;  // Caixa da net com margem: o nó precisa intersectá-la
+    BoundingBox region;   // Região da thread: o nó precisa estar contido nela
+    
+    bool allows(const RRNodeStore& nodes, int id) const {
+        return net_box.overlaps(nodes, id) && region.contains(nodes, id);
+    }
+};
 
 class Router {
 public:
     Router() = default;
+    explicit Router(const RouterOptions& options) : options_(options) {}
     
-    // Algoritmo de routing básico
+    // PathFinder: roteia, mede sobreuso e reroteia nets ilegais até
+    // a solução ficar legal ou atingir max_iterations
     std::vector<RouteTree> route(
-        const RoutingGraph& graph,
+        RoutingGraph& graph,
         const std::vector<Net>& nets
     );
     
+    // Modo incremental (ECO): routes[i] é a rota anterior da net i, já
+    // refletida na ocupação do grafo, ou vazia (routed == false) para as
+    // nets a rotear. Só as nets sem rota são roteadas na 1a iteração; nas
+    // seguintes, as que passam por nós sobreusados são arrancadas
+    std::vector<RouteTree> reroute(
+        RoutingGraph& graph,
+        const std::vector<Net>& nets,
+        std::vector<RouteTree> routes
+    );
+    
+    // STA consultada na busca (criticidade por conexão) e atualizada ao fim
+    // de cada iteração com as nets reroteadas; nullptr = criticality fixa.
+    // Deve ter sido construída com as mesmas nets passadas a route()
+    void setTimingAnalyzer(TimingAnalyzer* timing) { timing_ = timing; }
+    
+    // Resultado da última chamada a route()
+    bool isLegal() const { return legal_; }
+    int iterations() const { return iterations_; }
+    const RouterStats& stats() const { return stats_; }
+    
+    // Conexões da net (índice em route()), uma por sink
+    const std::vector<ConnectionState>& connections(int net_index) const {
+        return connections_[net_index];
+    }
+    
+    // Tempo de roteamento por net em ms, somado nas iterações (índice da
+    // net em route()); zerado sem ROUTER_PROFILING
+    const std::vector<double>& netTimes() const { return net_ms_; }
+    
 private:
-    // Dijkstra simplificado
+    // Iterações de rip-up/reroute a partir de results; incremental preserva
+    // as rotas existentes na 1a iteração
+    std::vector<RouteTree> negotiate(
+        RoutingGraph& graph,
+        const std::vector<Net>& nets,
+        std::vector<RouteTree> results,
+        bool incremental
+    );
+    
+    // Dijkstra/A* com a frente de onda semeada por toda a árvore parcial.
+    // Retorna o novo ramo; o primeiro elemento é o nó da árvore onde ele se conecta
     std::vector<int> findPath(
+        const RoutingGraph& graph,
+        const RouteTree& route_tree,
+        int sink_id,
+        float criticality,
+        const SearchBounds& bounds,
+        SearchWorkspace& workspace
+    );
+    
+    // Corpo da busca sobre a fila do backend escolhido em findPath
+    template <typename Queue>
+    std::vector<int> searchPath(
+        Queue& queue,
+        const RoutingGraph& graph,
+        const RouteTree& route_tree,
+        int sink_id,
+        float criticality,
+        const SearchBounds& bounds,
+        SearchWorkspace& workspace
+    );
+    
+    // Busca bidirecional de uma conexão cuja árvore é só a fonte: frentes
+    // a partir da fonte (arestas de saída) e do sink (arestas de entrada)
+    // até o encontro. Mesmo retorno de findPath
+    template <typename Queue>
+    std::vector<int> searchBidirectional(
+        Queue& forward,
+        Queue& backward,
         const RoutingGraph& graph,
         int source_id,
-        const std::vector<int>& sinks_ids
+        int sink_id,
+        float criticality,
+        const SearchBounds& bounds,
+        SearchWorkspace& workspace
     );
     
+    // Heurística do A*: astar_fac * lookahead até o sink
+    float expectedCost(const RoutingGraph& graph, int node_id, int sink_id, float criticality) const;
+    
+    // Criticidade da conexão (sink do índice dado da net): da STA se já
+    // houver análise, senão options_.criticality
+    float connectionCriticality(int net_index, int sink_index) const;
+    
+    // Roteia os sinks ainda sem ramo (todos, se a árvore estiver vazia) a
+    // partir da árvore existente e registra a ocupação dos nós novos
+    // (a busca não sai de bounds; usa o workspace da thread)
+    void routeNet(RoutingGraph& graph, const Net& net, int net_index, RouteTree& route_tree,
+                  const SearchBounds& bounds, SearchWorkspace& workspace);
+    
+    // Roteia a net dentro da sua caixa, ampliando a margem a cada falha
+    // até a caixa cobrir toda a região
+    void routeNetGrowing(RoutingGraph& graph, const Net& net, int net_index,
+                         RouteTree& route_tree, const BoundingBox& region,
+                         SearchWorkspace& workspace);
+    
+    // Remove a ocupação de uma rota do grafo
+    void ripUp(RoutingGraph& graph, RouteTree& route_tree);
+    
+    // Remove os nós de índice >= first_new (os pais vêm antes, então o
+    // restante continua uma árvore) e os sinks que terminavam neles
+    void ripUpFrom(RoutingGraph& graph, RouteTree& route_tree, size_t first_new);
+    
+    // Atualiza o estado das conexões de uma net roteada e poda da árvore
+    // os ramos das ilegais (e das críticas que pioraram), mantendo os nós
+    // ainda usados por outras conexões. Retorna quantas foram arrancadas
+    int ripUpConnections(RoutingGraph& graph, int net_index, RouteTree& route_tree);
+    
+    // Atraso e legalidade das conexões após rotear a net (depois de
+    // timing_->update(), quando houver STA)
+    void updateConnections(const RoutingGraph& graph, int net_index, const RouteTree& route_tree);
+    
+    // Por nó da árvore: o caminho desde a raiz passa por nó sobreusado?
+    static std::vector<char> illegalPaths(const RoutingGraph& graph, const RouteTree& route_tree);
+    
+    // Emite o log de uma net sem intercalar com outras threads
+    void flushLog(const std::ostringstream& log);
+    
+    // Extensão do grid ocupada pelo grafo
+    static BoundingBox deviceBox(const RoutingGraph& graph);
+    
+    // Caixa envolvente dos terminais da net, ampliada por margin e recortada em clip
+    static BoundingBox netBoundingBox(const RoutingGraph& graph, const Net& net,
+                                      int margin, const BoundingBox& clip);
+    
     // Calcular custo considerando congestionamento
-    float getNodeCost(const RRNode& node, float criticality);
+    float getNodeCost(const RoutingGraph& graph, int id, float criticality);
+    
+    RouterOptions options_;
+    RouterStats stats_;
+    RouterLookahead lookahead_;
+    std::unique_ptr<ThreadPool> pool_;
+    std::vector<SearchWorkspace> workspaces_;  // Um por thread, reutilizados entre buscas
+    std::mutex log_mutex_;
+    TimingAnalyzer* timing_ = nullptr;
+    float pres_fac_ = 0.0f;
+    std::vector<float> hist_cost_;  // Custo histórico por nó
+    std::vector<int> net_margin_;   // Margem atual da caixa de cada net
+    std::vector<double> net_ms_;    // Tempo acumulado por net (profiling)
+    std::vector<std::vector<ConnectionState>> connections_;  // Por net, por sink
+    bool legal_ = false;
+    int iterations_ = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
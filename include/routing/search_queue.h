@@ -0,0 +1,208 @@
+#ifndef ROUTING_SEARCH_QUEUE_H
+#define ROUTING_SEARCH_QUEUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Entrada da fila de busca
+struct HeapEntry {
+    int id;
+    float cost;           // Custo acumulado + estimativa do lookahead
+    float backward_cost;  // Custo acumulado desde a fonte
+
+    bool operator>(const HeapEntry& other) const {
+        return cost > other.cost;
+    }
+};
+
+// Backends da fila de prioridade do roteador. Todos têm a mesma
+// interface (push, top, pop, empty, clear) e guardam a memória entre buscas
+enum class QueueKind {
+    BINARY_HEAP,  // std::push_heap/pop_heap
+    FOUR_ARY_HEAP,
+    RADIX         // Radix heap monótono sobre custos quantizados
+};
+
+inline const char* queue_kind_name(QueueKind kind) {
+    switch (kind) {
+        case QueueKind::BINARY_HEAP: return "binary";
+        case QueueKind::FOUR_ARY_HEAP: return "4ary";
+        default: return "radix";
+    }
+}
+
+// Backend pelo nome de queue_kind_name; false se desconhecido
+inline bool parse_queue_kind(const std::string& name, QueueKind& kind) {
+    for (QueueKind k : {QueueKind::BINARY_HEAP, QueueKind::FOUR_ARY_HEAP, QueueKind::RADIX}) {
+        if (name == queue_kind_name(k)) {
+            kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Heap binário da STL (mínimo no topo)
+class BinaryHeapQueue {
+public:
+    void push(const HeapEntry& entry) {
+        heap_.push_back(entry);
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<HeapEntry>());
+    }
+
+    const HeapEntry& top() const { return heap_.front(); }
+
+    HeapEntry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<HeapEntry>());
+        HeapEntry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+    bool empty() const { return heap_.empty(); }
+    void clear() { heap_.clear(); }
+
+private:
+    std::vector<HeapEntry> heap_;
+};
+
+// Heap 4-ário: metade da altura do binário e os 4 filhos de um nó
+// contíguos (uma linha de cache), menos movimentos no sift-down
+class FourAryHeapQueue {
+public:
+    void push(const HeapEntry& entry) {
+        size_t i = heap_.size();
+        heap_.push_back(entry);
+        while (i > 0) {
+            size_t parent = (i - 1) / 4;
+            if (heap_[parent].cost <= entry.cost) break;
+            heap_[i] = heap_[parent];
+            i = parent;
+        }
+        heap_[i] = entry;
+    }
+
+    const HeapEntry& top() const { return heap_[0]; }
+
+    HeapEntry pop() {
+        HeapEntry top = heap_[0];
+        HeapEntry last = heap_.back();
+        heap_.pop_back();
+        size_t size = heap_.size();
+        if (size == 0) return top;
+
+        size_t i = 0;
+        while (true) {
+            size_t first = 4 * i + 1;
+            if (first >= size) break;
+            size_t end = std::min(first + 4, size);
+            size_t best = first;
+            for (size_t c = first + 1; c < end; ++c) {
+                if (heap_[c].cost < heap_[best].cost) best = c;
+            }
+            if (heap_[best].cost >= last.cost) break;
+            heap_[i] = heap_[best];
+            i = best;
+        }
+        heap_[i] = last;
+        return top;
+    }
+
+    bool empty() const { return heap_.empty(); }
+    void clear() { heap_.clear(); }
+
+private:
+    std::vector<HeapEntry> heap_;
+};
+
+// Radix heap: custo quantizado em passos de resolution vira chave inteira;
+// o balde i guarda chaves cujo bit mais alto diferente da última chave
+// retirada é o i-1 (balde 0 = empate com ela). Push e pop O(1) amortizado,
+// mas só vale para chaves monótonas: uma chave menor que a última
+// retirada (heurística inconsistente) é promovida a ela
+class RadixQueue {
+public:
+    explicit RadixQueue(float resolution = 1e-3f) { setResolution(resolution); }
+
+    void setResolution(float resolution) { scale_ = 1.0f / resolution; }
+
+    void push(const HeapEntry& entry) {
+        uint32_t key = std::max(quantize(entry.cost), last_);
+        buckets_[bucketOf(key)].push_back({key, entry});
+        size_++;
+    }
+
+    // Não é const: pode redistribuir os baldes
+    const HeapEntry& top() {
+        refill();
+        return buckets_[0].back().entry;
+    }
+
+    HeapEntry pop() {
+        refill();
+        HeapEntry top = buckets_[0].back().entry;
+        buckets_[0].pop_back();
+        size_--;
+        return top;
+    }
+
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        for (auto& bucket : buckets_) bucket.clear();
+        last_ = 0;
+        size_ = 0;
+    }
+
+private:
+    struct Item {
+        uint32_t key;
+        HeapEntry entry;
+    };
+
+    static const int NUM_BUCKETS = 33;
+
+    // Balde 0 vazio: a menor chave do primeiro balde não vazio vira a
+    // referência e as entradas dele descem para baldes mais baixos
+    void refill() {
+        if (!buckets_[0].empty()) return;
+        int b = 1;
+        while (buckets_[b].empty()) ++b;
+        auto& bucket = buckets_[b];
+        last_ = std::min_element(bucket.begin(), bucket.end(),
+            [](const Item& x, const Item& y) { return x.key < y.key; })->key;
+        for (const Item& item : bucket) buckets_[bucketOf(item.key)].push_back(item);
+        bucket.clear();
+    }
+
+    uint32_t quantize(float cost) const {
+        float scaled = cost * scale_;
+        if (!(scaled > 0.0f)) return 0;
+        if (scaled >= 4294967040.0f) return UINT32_MAX;
+        return static_cast<uint32_t>(scaled);
+    }
+
+    int bucketOf(uint32_t key) const {
+        uint32_t diff = key ^ last_;
+#if defined(__GNUC__)
+        return diff ? 32 - __builtin_clz(diff) : 0;
+#else
+        int bucket = 0;
+        while (diff) {
+            diff >>= 1;
+            bucket++;
+        }
+        return bucket;
+#endif
+    }
+
+    std::vector<Item> buckets_[NUM_BUCKETS];
+    uint32_t last_ = 0;
+    size_t size_ = 0;
+    float scale_ = 1000.0f;
+};
+
+#endif
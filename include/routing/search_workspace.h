@@ -0,0 +1,155 @@
+#ifndef ROUTING_SEARCH_WORKSPACE_H
+#define ROUTING_SEARCH_WORKSPACE_H
+
+#include "./types.h"
+#include "./profiling.h"
+#include "./search_queue.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Contadores de esforço de busca acumulados em route(); exceto connections,
+// só são contados com ROUTER_PROFILING
+struct RouterStats {
+    long long connections = 0;      // Buscas fonte -> sink executadas
+    long long bidirectional = 0;    // Das quais bidirecionais
+    long long heap_pushes = 0;
+    long long heap_pops = 0;
+    long long nodes_expanded = 0;   // Nós retirados do heap e expandidos
+    long long stale_pops = 0;       // Entradas descartadas: o nó já saiu com custo menor
+    long long reexpansions = 0;     // Nós expandidos de novo após o custo melhorar
+    long long edges_relaxed = 0;    // Arestas avaliadas dentro dos limites da busca
+    
+    void merge(const RouterStats& other) {
+        connections += other.connections;
+        bidirectional += other.bidirectional;
+        heap_pushes += other.heap_pushes;
+        heap_pops += other.heap_pops;
+        nodes_expanded += other.nodes_expanded;
+        stale_pops += other.stale_pops;
+        reexpansions += other.reexpansions;
+        edges_relaxed += other.edges_relaxed;
+    }
+};
+
+// Filas reutilizáveis, uma por backend; a busca usa a do escolhido
+struct SearchQueues {
+    BinaryHeapQueue binary_heap;
+    FourAryHeapQueue four_ary_heap;
+    RadixQueue radix_queue;
+};
+
+// Estado de busca reutilizável de uma thread. Vetores planos indexados
+// por nó são invalidados por época: iniciar uma busca custa O(1) e só
+// as entradas tocadas são escritas.
+class SearchWorkspace {
+public:
+    SearchWorkspace() = default;
+    
+    // Ajusta os vetores ao grafo (só realoca se o número de nós mudar)
+    void resize(size_t num_nodes) {
+        if (state_.size() != num_nodes) {
+            state_.assign(num_nodes, {0.0f, -1, 0});
+            reverse_.clear();
+            tree_.assign(num_nodes, {-1, 0});
+#if ROUTER_PROFILING
+            expanded_.assign(num_nodes, 0);
+#endif
+            search_epoch_ = 0;
+            tree_epoch_ = 0;
+        }
+    }
+    
+    // Nova busca: invalida custos/predecessores (a fila é esvaziada por quem a usa)
+    void beginSearch() {
+        if (++search_epoch_ == 0) {
+            for (auto& s : state_) s.epoch = 0;
+            for (auto& s : reverse_) s.epoch = 0;
+#if ROUTER_PROFILING
+            std::fill(expanded_.begin(), expanded_.end(), 0);
+#endif
+            search_epoch_ = 1;
+        }
+    }
+    
+    float cost(int node) const {
+        const NodeState& s = state_[node];
+        return s.epoch == search_epoch_ ? s.cost : std::numeric_limits<float>::infinity();
+    }
+    
+    int prev(int node) const { return state_[node].prev; }
+    
+    void setCost(int node, float cost, int prev) {
+        state_[node] = {cost, prev, search_epoch_};
+    }
+    
+    // Lado do sink da busca bidirecional: custo até o sink e próximo nó
+    // do caminho. Os vetores só são alocados na primeira busca desse tipo
+    void enableReverse() {
+        if (reverse_.size() != state_.size()) reverse_.assign(state_.size(), {0.0f, -1, 0});
+    }
+    
+    float reverseCost(int node) const {
+        const NodeState& s = reverse_[node];
+        return s.epoch == search_epoch_ ? s.cost : std::numeric_limits<float>::infinity();
+    }
+    
+    int next(int node) const { return reverse_[node].prev; }
+    
+    void setReverseCost(int node, float cost, int next) {
+        reverse_[node] = {cost, next, search_epoch_};
+    }
+    
+#if ROUTER_PROFILING
+    // Marca o nó como expandido nesta busca; true se já tinha sido
+    bool markExpanded(int node) {
+        bool again = expanded_[node] == search_epoch_;
+        expanded_[node] = search_epoch_;
+        return again;
+    }
+#endif
+    
+    // Nova árvore de roteamento: invalida o mapa nó RR -> índice na árvore
+    void beginTree() {
+        if (++tree_epoch_ == 0) {
+            for (auto& t : tree_) t.epoch = 0;
+            tree_epoch_ = 1;
+        }
+    }
+    
+    int treeIndex(int node) const {
+        const TreeState& t = tree_[node];
+        return t.epoch == tree_epoch_ ? t.index : -1;
+    }
+    
+    void setTreeIndex(int node, int index) { tree_[node] = {index, tree_epoch_}; }
+    
+    SearchQueues queues;          // Busca a partir da árvore
+    SearchQueues reverse_queues;  // Lado do sink na busca bidirecional
+    
+    RouterStats stats;
+    
+private:
+    struct NodeState {
+        float cost;
+        int prev;
+        uint32_t epoch;
+    };
+    
+    struct TreeState {
+        int index;
+        uint32_t epoch;
+    };
+    
+    std::vector<NodeState> state_;
+    std::vector<NodeState> reverse_;
+    std::vector<TreeState> tree_;
+#if ROUTER_PROFILING
+    std::vector<uint32_t> expanded_;  // Época da última expansão de cada nó
+#endif
+    uint32_t search_epoch_ = 0;
+    uint32_t tree_epoch_ = 0;
+};
+
+#endif
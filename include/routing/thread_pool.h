@@ -0,0 +1,40 @@
+#ifndef ROUTING_THREAD_POOL_H
+#define ROUTING_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool fixo de threads para laços paralelos do roteador
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    int size() const { return static_cast<int>(workers_.size()); }
+    
+    // Executa task(i, worker) para i em [0, count) e espera todas terminarem
+    void run(int count, const std::function<void(int, int)>& task);
+    
+private:
+    void workerLoop(int worker);
+    
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int, int)>* task_ = nullptr;
+    int count_ = 0;
+    std::atomic<int> next_{0};
+    int active_ = 0;
+    long generation_ = 0;
+    bool stop_ = false;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef ROUTING_TIMING_H
+#define ROUTING_TIMING_H
+
+#include "./types.h"
+#include "../architecture/types.h"
+#include "../netlist/types.h"
+#include <vector>
+
+// Parâmetros da análise de timing
+struct TimingOptions {
+    float clock_period = 0.0f;     // ns; 0 = usar o caminho crítico atual
+    float block_delay = 0.0f;      // Atraso (ns) de atravessar um bloco combinacional
+    float max_criticality = 0.99f; // Teto da criticidade (mantém algum peso de congestionamento)
+    float criticality_exp = 1.0f;  // Expoente aplicado à criticidade
+};
+
+// STA incremental sobre as conexões roteadas (driver -> sink de cada net).
+// Blocos io são início e fim de caminho; os demais são combinacionais com
+// atraso constante. O atraso de cada conexão é o Elmore da árvore de rota,
+// com R/Cin/Cout/Tdel dos switches e Rmetal/Cmetal dos segmentos.
+// Após updateNet(), update() propaga só a partir dos blocos afetados
+class TimingAnalyzer {
+public:
+    TimingAnalyzer() = default;
+
+    // Grafo de timing dos blocos; nets[i] deve ter driver_block/sink_blocks
+    // (terminais sem bloco viram início/fim de caminho). Laços de blocos
+    // combinacionais são cortados
+    void build(const FPGAArchitecture& arch, const PackedNetlist& netlist,
+               const std::vector<Net>& nets, const TimingOptions& options = TimingOptions());
+
+    // Recalcula o atraso das conexões da net a partir da sua árvore de rota
+    void updateNet(const RoutingGraph& graph, int net, const RouteTree& tree);
+
+    // Propaga chegadas e atrasos restantes dos blocos alterados
+    void update();
+
+    // Já houve ao menos um update()?
+    bool ready() const { return ready_; }
+
+    // Conexão k (sink k da net) em ns e criticidade em [0, max_criticality]
+    float connectionDelay(int net, int sink) const { return conn_delay_[conn_begin_[net] + sink]; }
+    float slack(int net, int sink) const;
+    float criticality(int net, int sink) const;
+
+    // Maior atraso entre início e fim de caminho
+    float criticalPathDelay() const { return critical_path_; }
+
+    // Período usado para os tempos requeridos
+    float period() const;
+
+    // Chegada, requerido e folga por nó SINK (a pior conexão em cada um)
+    void exportTo(TimingConstraints& timing, const std::vector<Net>& nets) const;
+
+private:
+    // Atraso a partir da entrada do bloco até um fim de caminho
+    float downstream(int block) const;
+    float arrival(int block) const { return block < 0 ? 0.0f : arrival_[block]; }
+
+    // Recalcula um bloco; retorna true se o valor mudou
+    bool updateArrival(int block);
+    bool updateDownstream(int block);
+
+    // Caminho que passa pelo item: bloco b (chegada + atraso restante) ou,
+    // para item >= blocos, a conexão órfã item - blocos
+    float pathDelay(int item) const;
+
+    // Registra o valor atual do item no heap do caminho crítico
+    void touchPath(int item);
+    void rebuildPathHeap();
+
+    // Atraso (ns) dos sinks da árvore, indexados como tree.sink_branches
+    void elmoreDelays(const RoutingGraph& graph, const RouteTree& tree, std::vector<float>& delays);
+
+    TimingOptions options_;
+    std::vector<Switch> switches_;
+    std::vector<char> switch_buffered_;  // Switch isola a capacitância a jusante?
+
+    // Conexões: as da net n ocupam [conn_begin_[n], conn_begin_[n + 1])
+    std::vector<int> conn_begin_;
+    std::vector<int> conn_driver_;  // Bloco driver (-1 = sem bloco)
+    std::vector<int> conn_sink_;    // Bloco sink (-1 = sem bloco)
+    std::vector<float> conn_delay_;
+    std::vector<int> orphan_conns_; // Conexões sem bloco driver (não entram em out_dn_)
+
+    // Blocos: conexões de entrada e saída em CSR, ordem topológica e tipo
+    std::vector<int> fanin_begin_, fanin_;
+    std::vector<int> fanout_begin_, fanout_;
+    std::vector<int> topo_index_;
+    std::vector<char> boundary_;    // Início e fim de caminho (io ou laço cortado)
+    std::vector<float> arrival_;    // Chegada na saída do bloco
+    std::vector<float> out_dn_;     // Maior atraso da saída do bloco até um fim de caminho
+
+    // Heap de máximo dos caminhos por item, com uma entrada a cada mudança;
+    // a entrada vale enquanto o seu delay for o atual do item
+    struct PathEntry {
+        float delay;
+        int item;
+    };
+    std::vector<PathEntry> path_heap_;
+    std::vector<int> orphan_of_conn_;               // Índice em orphan_conns_ (-1 se não é órfã)
+    std::vector<int> orphan_begin_, orphan_by_sink_; // Órfãs por bloco sink + 1 (CSR; sink -1 primeiro)
+
+    // Blocos pendentes de update()
+    std::vector<int> dirty_forward_, dirty_backward_;
+    std::vector<char> queued_forward_, queued_backward_;
+
+    // Buffers do Elmore, reutilizados entre nets
+    std::vector<float> c_down_, node_delay_;
+
+    float critical_path_ = 0.0f;
+    bool ready_ = false;
+};
+
+#endif
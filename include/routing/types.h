@@ -5,6 +5,12 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include "./occupancy.h"
 
 // Tipos de nós do RRGraph
 enum class RRNodeType {
@@ -19,6 +25,7 @@ enum class RRNodeType {
     EDGE            // Aresta (switches)
 };
 
+// Nó completo, usado na construção do grafo; o armazenamento é RRNodeStore
 struct RRNode {
     int id;
     RRNodeType type;
@@ -26,7 +33,6 @@ struct RRNode {
     int x_low, y_low, x_high, y_high;
     int ptc;
     int capacity;
-    int used;  // Quantas nets usando este nó
     float base_cost;
     float delay;
     std::string name;
@@ -39,6 +45,117 @@ struct RREdge {
     float delay;
 };
 
+// Vetor que é dono dos seus dados ou vista sobre um bloco externo
+// (o arquivo mapeado do cache do grafo). Só vetores donos mudam de tamanho
+template <typename T>
+class RRArray {
+public:
+    T* data() { return view_ ? view_ : owned_.data(); }
+    const T* data() const { return view_ ? view_ : owned_.data(); }
+    size_t size() const { return view_ ? view_size_ : owned_.size(); }
+    bool empty() const { return size() == 0; }
+    bool isView() const { return view_ != nullptr; }
+    
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    T* begin() { return data(); }
+    T* end() { return data() + size(); }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+    
+    void assign(size_t n, const T& value) { view_ = nullptr; owned_.assign(n, value); }
+    void resize(size_t n) { view_ = nullptr; owned_.resize(n); }
+    void push_back(const T& value) { view_ = nullptr; owned_.push_back(value); }
+    
+    void setView(T* data, size_t size) {
+        std::vector<T>().swap(owned_);
+        view_ = data;
+        view_size_ = size;
+    }
+    
+private:
+    std::vector<T> owned_;
+    T* view_ = nullptr;
+    size_t view_size_ = 0;
+};
+
+// Resistência (ohms) e capacitância (F) de um nó; só fios têm valores não nulos
+struct RRNodeRC {
+    float R;
+    float C;
+};
+
+// Nós do RRGraph em estrutura de arrays: o laço de expansão lê só os campos
+// de que precisa. Coordenadas em int16, tipo em uint8 e o nome é um índice
+// na tabela de nomes internados (~27 bytes por nó)
+struct RRNodeStore {
+    RRArray<uint8_t> types;
+    RRArray<int16_t> x_low, y_low, x_high, y_high;
+    RRArray<int16_t> ptc;
+    RRArray<uint16_t> capacity;
+    RRArray<float> base_cost;
+    RRArray<float> delay;
+    RRArray<uint16_t> name_id;
+    RRArray<uint16_t> rc_index;
+    std::vector<std::string> names;  // Nomes distintos, internados por internName()
+    std::vector<RRNodeRC> rc_data;   // Pares (R, C) distintos; rc_data[0] = {0, 0}
+    
+    // Faixa dos tipos compactos: coordenadas e ptc em int16; capacidade e
+    // índices de nome e de R/C em uint16
+    static const int MAX_COORD = INT16_MAX;
+    static const int MAX_INDEX = UINT16_MAX;
+    
+    size_t size() const { return types.size(); }
+    bool empty() const { return types.empty(); }
+    RRNodeType type(int id) const { return static_cast<RRNodeType>(types[id]); }
+    const std::string& name(int id) const { return names[name_id[id]]; }
+    const RRNodeRC& rc(int id) const { return rc_data[rc_index[id]]; }
+    
+    // Redimensiona com nós zerados
+    void resize(size_t n);
+    
+    // Acrescenta um nó internando o nome (construção serial); retorna o id
+    int add(const RRNode& node);
+    
+    // Grava o nó id com um nome já internado; ids distintos podem ser
+    // gravados em paralelo
+    void set(int id, const RRNode& node, int name);
+    
+    // Nó completo (fora do caminho crítico)
+    RRNode get(int id) const;
+    
+    // Índice do nome na tabela, inserindo se for novo (não é thread-safe)
+    int internName(const std::string& name);
+    
+    // Índice do par (R, C) em rc_data, inserindo se for novo (não é thread-safe)
+    int internRC(float R, float C);
+    
+private:
+    std::unordered_map<std::string, int> name_index_;
+};
+
+// Retângulo de posições do grid (limites inclusivos)
+struct BoundingBox {
+    int x_min, y_min, x_max, y_max;
+    
+    bool contains(const BoundingBox& other) const {
+        return other.x_min >= x_min && other.x_max <= x_max &&
+               other.y_min >= y_min && other.y_max <= y_max;
+    }
+    
+    // Nó inteiramente dentro da caixa (fios longos contam toda a extensão)
+    bool contains(const RRNodeStore& nodes, int id) const {
+        return nodes.x_low[id] >= x_min && nodes.x_high[id] <= x_max &&
+               nodes.y_low[id] >= y_min && nodes.y_high[id] <= y_max;
+    }
+    
+    // Nó com alguma parte dentro da caixa
+    bool overlaps(const RRNodeStore& nodes, int id) const {
+        return nodes.x_high[id] >= x_min && nodes.x_low[id] <= x_max &&
+               nodes.y_high[id] >= y_min && nodes.y_low[id] <= y_max;
+    }
+};
+
 struct TimingConstraints {
     float clock_period;
     std::map<int, float> arrival_times;
@@ -46,44 +163,164 @@ struct TimingConstraints {
     std::map<int, float> slacks;
 };
 
+// Switch do RRGraph: par (switch da arquitetura, atraso) internado por freeze()
+struct RRSwitch {
+    int switch_id;
+    float delay;
+};
+
+// Aresta na forma CSR: nó do outro extremo e índice na tabela de switches
+struct RRAdjEdge {
+    int node;       // destino (out_edges) ou origem (in_edges)
+    int rr_switch;  // índice em RoutingGraph::switches
+};
+
+// Visão de uma aresta durante a expansão
+struct RREdgeView {
+    int id;         // posição no CSR
+    int node;
+    float delay;
+    int switch_id;
+};
+
+struct RREdgeIterator {
+    const RRAdjEdge* edge;
+    const RRAdjEdge* base;
+    const RRSwitch* switches;
+
+    RREdgeView operator*() const {
+        const RRSwitch& sw = switches[edge->rr_switch];
+        return {static_cast<int>(edge - base), edge->node, sw.delay, sw.switch_id};
+    }
+    RREdgeIterator& operator++() { ++edge; return *this; }
+    bool operator!=(const RREdgeIterator& other) const { return edge != other.edge; }
+};
+
+// Faixa contígua de arestas de um nó no CSR
+struct RREdgeRange {
+    const RRAdjEdge* first;
+    const RRAdjEdge* last;
+    const RRAdjEdge* base;
+    const RRSwitch* switches;
+
+    RREdgeIterator begin() const { return {first, base, switches}; }
+    RREdgeIterator end() const { return {last, base, switches}; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+};
+
+class ThreadPool;
+
 struct RoutingGraph {
-    std::vector<RRNode> nodes;
-    std::vector<RREdge> edges;
-    std::map<int, std::vector<int>> adjacency_list;     // node_id -> [neighbor_ids]
-    std::map<int, std::vector<int>> reverse_adjacency;  // Para busca bidirecional
+    RRNodeStore nodes;
+    std::vector<RREdge> edges;  // Lista de construção, liberada por freeze()
+
+    // Forma CSR congelada: arestas do nó i em [offsets[i], offsets[i+1])
+    RRArray<int> out_offsets;
+    RRArray<RRAdjEdge> out_edges;
+    RRArray<int> in_offsets;      // Para busca bidirecional
+    RRArray<RRAdjEdge> in_edges;
+    RRArray<RRSwitch> switches;
     TimingConstraints timing;
+    RROccupancy occupancy;        // Quantas nets usam cada nó (dimensionada por freeze())
+    
+    // Memória que sustenta as vistas acima quando o grafo veio do cache
+    std::shared_ptr<const void> storage;
     
     // Métodos utilitários
-    void addNode(const RRNode& node) {
-        nodes.push_back(node);
+    int addNode(const RRNode& node) {
+        return nodes.add(node);
     }
     
     void addEdge(const RREdge& edge) {
         edges.push_back(edge);
-        adjacency_list[edge.from_node].push_back(edge.to_node);
-        reverse_adjacency[edge.to_node].push_back(edge.from_node);
     }
     
-    // Novo: obter nós adjacentes
-    const std::vector<int>& getNeighbors(int node_id) const {
-        static const std::vector<int> empty;
-        auto it = adjacency_list.find(node_id);
-        return it != adjacency_list.end() ? it->second : empty;
+    // Converte a lista de arestas para CSR (chamar após construir o grafo)
+    void freeze();
+    
+    // Converte listas de arestas geradas por faixas de nós para CSR. A faixa b
+    // começa no nó band_begin[b]; cada faixa ordena as arestas cujo extremo é
+    // dela, sem locks. O resultado é igual ao de freeze() com as listas
+    // concatenadas em ordem. pool nulo roda em série
+    void freeze(std::vector<std::vector<RREdge>>& band_edges,
+                const std::vector<int>& band_begin, ThreadPool* pool);
+    
+    bool isFrozen() const {
+        return out_offsets.size() == nodes.size() + 1;
+    }
+    
+    size_t numEdges() const {
+        return isFrozen() ? out_edges.size() : edges.size();
+    }
+    
+    // Arestas de saída do nó (requer grafo congelado)
+    RREdgeRange outEdges(int node_id) const {
+        const RRAdjEdge* base = out_edges.data();
+        return {base + out_offsets[node_id], base + out_offsets[node_id + 1],
+                base, switches.data()};
+    }
+    
+    // Arestas de entrada do nó (requer grafo congelado)
+    RREdgeRange inEdges(int node_id) const {
+        const RRAdjEdge* base = in_edges.data();
+        return {base + in_offsets[node_id], base + in_offsets[node_id + 1],
+                base, switches.data()};
     }
     
-    // Novo: resetar uso
+    // Atributos de uma aresta de saída pelo id em O(1)
+    RREdgeView edge(int edge_id) const {
+        const RRAdjEdge& e = out_edges[edge_id];
+        const RRSwitch& sw = switches[e.rr_switch];
+        return {edge_id, e.node, sw.delay, sw.switch_id};
+    }
+    
+    // Id da aresta from -> to, ou -1 (percorre só as arestas de from)
+    int findEdge(int from_node, int to_node) const {
+        for (int i = out_offsets[from_node]; i < out_offsets[from_node + 1]; ++i) {
+            if (out_edges[i].node == to_node) return i;
+        }
+        return -1;
+    }
+    
+    // Zera a ocupação (O(1) quando já dimensionada)
     void resetUsage() {
-        for (auto& node : nodes) {
-            node.used = 0;
+        if (occupancy.size() != nodes.size()) {
+            occupancy.init(nodes);
+        } else {
+            occupancy.reset();
         }
     }
 };
 
+// Nó da árvore de roteamento; o pai sempre aparece antes dos filhos
+struct RouteTreeNode {
+    int rr_node;
+    int parent;     // Índice do pai em RouteTree::nodes (-1 na raiz)
+    float delay;    // Atraso acumulado desde a fonte
+    int switch_id;  // Switch da arquitetura na aresta vinda do pai (-1 se não houver)
+};
+
 struct RouteTree {
     int net_id;
-    std::vector<int> nodes;  // IDs dos nós usados na rota
-    float total_delay;
+    std::vector<RouteTreeNode> nodes;  // nodes[0] é a fonte da net
+    std::vector<int> sink_branches;    // Por sink da net: índice do nó final (-1 se não roteado)
+    float total_delay;                 // Maior atraso fonte -> sink
     bool routed;
+    
+    int addNode(int rr_node, int parent, float delay, int switch_id = -1) {
+        nodes.push_back({rr_node, parent, delay, switch_id});
+        return static_cast<int>(nodes.size()) - 1;
+    }
+    
+    // Nós RR do ramo da fonte até o nó de índice tree_index
+    std::vector<int> branch(int tree_index) const {
+        std::vector<int> path;
+        for (int i = tree_index; i >= 0; i = nodes[i].parent) {
+            path.push_back(nodes[i].rr_node);
+        }
+        return std::vector<int>(path.rbegin(), path.rend());
+    }
 };
 
 #endif
\ No newline at end of file
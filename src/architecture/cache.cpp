@@ -0,0 +1,390 @@
+#include "./cache.h"
+#include "./parser.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'F', 'P', 'G', 'A', 'A', 'R', 'C', 'H'};
+const uint32_t CACHE_ENDIAN = 0x01020304;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint64_t xml_hash;
+    uint64_t payload_bytes;
+};
+
+// Serialização em fluxo: PODs copiados como estão, strings com tamanho antes
+class Writer {
+public:
+    template <typename T>
+    void pod(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data_.append(bytes, sizeof(T));
+    }
+
+    void str(const std::string& text) {
+        pod(static_cast<uint32_t>(text.size()));
+        data_ += text;
+    }
+
+    void count(size_t n) { pod(static_cast<uint32_t>(n)); }
+
+    const std::string& data() const { return data_; }
+
+private:
+    std::string data_;
+};
+
+// Leitura com verificação de limites: ao passar do fim, ok() vira false e
+// tudo passa a ler zero
+class Reader {
+public:
+    Reader(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+    template <typename T>
+    void pod(T& value) {
+        if (static_cast<size_t>(end_ - pos_) < sizeof(T)) {
+            fail();
+            value = T();
+            return;
+        }
+        std::memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+    }
+
+    void str(std::string& text) {
+        uint32_t size = 0;
+        pod(size);
+        if (static_cast<size_t>(end_ - pos_) < size) {
+            fail();
+            text.clear();
+            return;
+        }
+        text.assign(pos_, size);
+        pos_ += size;
+    }
+
+    // Número de elementos; limitado pelo que resta no buffer para que um
+    // arquivo corrompido não peça uma alocação enorme
+    size_t count() {
+        uint32_t n = 0;
+        pod(n);
+        if (n > static_cast<size_t>(end_ - pos_)) {
+            fail();
+            return 0;
+        }
+        return n;
+    }
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == end_; }
+
+private:
+    void fail() {
+        ok_ = false;
+        pos_ = end_;
+    }
+
+    const char* pos_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+void write_arch(Writer& out, const FPGAArchitecture& arch) {
+    const Device& device = arch.device;
+    out.pod(device.R_minW_nmos);
+    out.pod(device.R_minW_pmos);
+    out.pod(device.grid_logic_tile_area);
+    out.str(device.switch_block_type);
+    out.str(device.connection_block_switch);
+    out.pod(static_cast<int32_t>(device.fs));
+
+    out.count(arch.switches.size());
+    for (const Switch& sw : arch.switches) {
+        out.str(sw.type);
+        out.str(sw.name);
+        for (double value : {sw.R, sw.Cin, sw.Cout, sw.Tdel, sw.mux_trans_size, sw.buf_size}) {
+            out.pod(value);
+        }
+    }
+
+    out.count(arch.segments.size());
+    for (const Segment& seg : arch.segments) {
+        out.pod(seg.freq);
+        out.pod(static_cast<int32_t>(seg.length));
+        out.str(seg.type);
+        out.pod(seg.Rmetal);
+        out.pod(seg.Cmetal);
+        out.str(seg.mux_name);
+    }
+
+    out.count(arch.directs.size());
+    for (const Direct& dir : arch.directs) {
+        out.str(dir.name);
+        out.str(dir.from_pin);
+        out.str(dir.to_pin);
+        for (int value : {dir.x_offset, dir.y_offset, dir.z_offset}) {
+            out.pod(static_cast<int32_t>(value));
+        }
+    }
+
+    out.count(arch.tiles.size());
+    for (const Tile& tile : arch.tiles) {
+        out.str(tile.name);
+        out.str(tile.type);
+        out.pod(static_cast<int32_t>(tile.height));
+        out.pod(static_cast<int32_t>(tile.capacity));
+        out.pod(tile.area);
+        out.pod(tile.fc_in);
+        out.pod(tile.fc_out);
+        out.count(tile.ports.size());
+        for (const Port& port : tile.ports) {
+            out.str(port.name);
+            out.str(port.type);
+            out.pod(static_cast<int32_t>(port.num_pins));
+            out.pod(static_cast<uint8_t>(port.is_clock));
+            out.pod(static_cast<uint8_t>(port.equivalent));
+        }
+    }
+
+    out.pod(arch.layout.aspect_ratio);
+    out.count(arch.layout.rules.size());
+    for (const GridRule& rule : arch.layout.rules) {
+        out.str(rule.kind);
+        out.str(rule.type);
+        for (int value : {rule.priority, rule.startx, rule.starty, rule.repeatx, rule.repeaty}) {
+            out.pod(static_cast<int32_t>(value));
+        }
+    }
+}
+
+int read_int(Reader& in) {
+    int32_t value = 0;
+    in.pod(value);
+    return value;
+}
+
+bool read_bool(Reader& in) {
+    uint8_t value = 0;
+    in.pod(value);
+    return value != 0;
+}
+
+void read_arch(Reader& in, FPGAArchitecture& arch) {
+    Device& device = arch.device;
+    in.pod(device.R_minW_nmos);
+    in.pod(device.R_minW_pmos);
+    in.pod(device.grid_logic_tile_area);
+    in.str(device.switch_block_type);
+    in.str(device.connection_block_switch);
+    device.fs = read_int(in);
+
+    arch.switches.resize(in.count());
+    for (Switch& sw : arch.switches) {
+        in.str(sw.type);
+        in.str(sw.name);
+        for (double* value : {&sw.R, &sw.Cin, &sw.Cout, &sw.Tdel, &sw.mux_trans_size, &sw.buf_size}) {
+            in.pod(*value);
+        }
+    }
+
+    arch.segments.resize(in.count());
+    for (Segment& seg : arch.segments) {
+        in.pod(seg.freq);
+        seg.length = read_int(in);
+        in.str(seg.type);
+        in.pod(seg.Rmetal);
+        in.pod(seg.Cmetal);
+        in.str(seg.mux_name);
+    }
+
+    arch.directs.resize(in.count());
+    for (Direct& dir : arch.directs) {
+        in.str(dir.name);
+        in.str(dir.from_pin);
+        in.str(dir.to_pin);
+        for (int* value : {&dir.x_offset, &dir.y_offset, &dir.z_offset}) {
+            *value = read_int(in);
+        }
+    }
+
+    arch.tiles.resize(in.count());
+    for (Tile& tile : arch.tiles) {
+        in.str(tile.name);
+        in.str(tile.type);
+        tile.height = read_int(in);
+        tile.capacity = read_int(in);
+        in.pod(tile.area);
+        in.pod(tile.fc_in);
+        in.pod(tile.fc_out);
+        tile.ports.resize(in.count());
+        for (Port& port : tile.ports) {
+            in.str(port.name);
+            in.str(port.type);
+            port.num_pins = read_int(in);
+            port.is_clock = read_bool(in);
+            port.equivalent = read_bool(in);
+        }
+    }
+
+    in.pod(arch.layout.aspect_ratio);
+    arch.layout.rules.resize(in.count());
+    for (GridRule& rule : arch.layout.rules) {
+        in.str(rule.kind);
+        in.str(rule.type);
+        for (int* value : {&rule.priority, &rule.startx, &rule.starty, &rule.repeatx, &rule.repeaty}) {
+            *value = read_int(in);
+        }
+    }
+}
+
+bool read_file(const std::string& filename, std::string& contents) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    if (size < 0) return false;
+    contents.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(&contents[0], size));
+}
+
+} // namespace
+
+uint64_t hash_architecture_text(const std::string& text) {
+    // Passo de 8 bytes: o hash byte a byte custava mais que ler o cache
+    uint64_t hash = 1469598103934665603ull ^ text.size();
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, text.data() + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < text.size(); ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash ^ (hash >> 32);
+}
+
+std::string architecture_cache_path(const std::string& dir, uint64_t hash) {
+    std::ostringstream name;
+    name << dir << "/arch_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return name.str();
+}
+
+bool save_architecture_cache(const std::string& filename, const FPGAArchitecture& arch,
+                             uint64_t hash) {
+    Writer payload;
+    write_arch(payload, arch);
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = ARCH_CACHE_VERSION;
+    header.endian = CACHE_ENDIAN;
+    header.xml_hash = hash;
+    header.payload_bytes = payload.data().size();
+
+    // Temporário por processo e thread: no modo em lote duas variantes
+    // iguais podem gravar o mesmo arquivo ao mesmo tempo
+    std::ostringstream tmp;
+    tmp << filename << ".tmp." << getpid() << "."
+        << std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::string tmp_name = tmp.str();
+
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(payload.data().data(), static_cast<std::streamsize>(payload.data().size()));
+    out.close();
+
+    if (!out || std::rename(tmp_name.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_name.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool load_architecture_cache(const std::string& filename, uint64_t hash,
+                             FPGAArchitecture& arch) {
+    std::string contents;
+    if (!read_file(filename, contents) || contents.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != ARCH_CACHE_VERSION || header.endian != CACHE_ENDIAN ||
+        header.xml_hash != hash ||
+        header.payload_bytes != contents.size() - sizeof(CacheHeader)) {
+        return false;
+    }
+
+    FPGAArchitecture loaded;
+    Reader in(contents.data() + sizeof(CacheHeader), contents.data() + contents.size());
+    read_arch(in, loaded);
+    if (!in.ok() || !in.atEnd()) return false;
+
+    arch = std::move(loaded);
+    return true;
+}
+
+FPGAArchitecture load_architecture(const std::string& filename, const std::string& cache_dir,
+                                   uint64_t* text_hash) {
+    if (text_hash) *text_hash = 0;
+    if (cache_dir.empty() && !text_hash) return parse_architecture_xml(filename);
+
+    std::string text;
+    if (!read_file(filename, text)) return FPGAArchitecture();
+
+    uint64_t hash = hash_architecture_text(text);
+    if (text_hash) *text_hash = hash;
+    if (cache_dir.empty()) return parse_architecture_text(text);
+
+    std::string cache_file = architecture_cache_path(cache_dir, hash);
+    FPGAArchitecture arch;
+    if (load_architecture_cache(cache_file, hash, arch)) return arch;
+
+    arch = parse_architecture_text(text);
+    // XML inválido não vai para o cache
+    if (!arch.tiles.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(cache_dir, error);
+        save_architecture_cache(cache_file, arch, hash);
+    }
+    return arch;
+}
+
+std::vector<FPGAArchitecture> load_architectures(const std::vector<std::string>& filenames,
+                                                 const std::string& cache_dir,
+                                                 int num_threads) {
+    std::vector<FPGAArchitecture> result(filenames.size());
+    int workers = static_cast<int>(std::min<size_t>(std::max(1, num_threads), filenames.size()));
+
+    // Cada thread pega o próximo arquivo livre; os documentos tinyxml2 são
+    // locais a cada parse
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t i = next++; i < filenames.size(); i = next++) {
+            result[i] = load_architecture(filenames[i], cache_dir);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < workers; ++t) threads.emplace_back(work);
+    work();
+    for (auto& thread : threads) thread.join();
+    return result;
+}
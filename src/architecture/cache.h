@@ -0,0 +1,41 @@
+#ifndef ARCHITECTURE_CACHE_H
+#define ARCHITECTURE_CACHE_H
+
+#include "architecture/types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Versão do formato binário; incrementar a cada mudança em FPGAArchitecture
+const uint32_t ARCH_CACHE_VERSION = 1;
+
+// Hash de 64 bits do texto do XML (FNV-1a em palavras de 8 bytes)
+uint64_t hash_architecture_text(const std::string& text);
+
+// Arquivo de cache do hash dentro de dir
+std::string architecture_cache_path(const std::string& dir, uint64_t hash);
+
+// Grava a arquitetura já parseada (escreve num temporário e renomeia)
+bool save_architecture_cache(const std::string& filename, const FPGAArchitecture& arch,
+                             uint64_t hash);
+
+// Lê o cache; retorna false se faltar o arquivo, se versão/hash não
+// baterem ou se estiver truncado. arch só é alterada em caso de sucesso
+bool load_architecture_cache(const std::string& filename, uint64_t hash,
+                             FPGAArchitecture& arch);
+
+// Lê o XML uma vez, usa o cache em cache_dir se o hash do conteúdo bater e,
+// senão, faz o parse e grava o cache. cache_dir vazio desliga o cache.
+// Se hash não for nulo, recebe hash_architecture_text do XML (0 se não
+// abrir), para chavear outros caches sem reler o arquivo
+FPGAArchitecture load_architecture(const std::string& filename, const std::string& cache_dir,
+                                   uint64_t* hash = nullptr);
+
+// Modo em lote para varreduras de arquitetura: carrega todos os arquivos
+// com load_architecture em num_threads threads (result[i] <-> filenames[i]).
+// Cada thread tem seu próprio documento tinyxml2; nada é compartilhado
+std::vector<FPGAArchitecture> load_architectures(const std::vector<std::string>& filenames,
+                                                 const std::string& cache_dir,
+                                                 int num_threads);
+
+#endif
@@ -1,13 +1,13 @@
 #include "./parser.h"
 #include "tinyxml2.h"
-#include <functional>
+#include <cstring>
+#include <vector>
 using namespace tinyxml2;
 
-FPGAArchitecture parse_architecture_xml(const std::string& filename) {
+namespace {
+
+FPGAArchitecture parse_document(XMLDocument& doc) {
     FPGAArchitecture arch;
-    XMLDocument doc;
-    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS) return arch;
-    
     arch.device = {0.0, 0.0, 0.0, "", "", 0};
     
     XMLElement* root = doc.RootElement();
@@ -82,9 +82,15 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
     
     XMLElement* complexblocklist_elem = root->FirstChildElement("complexblocklist");
     if (complexblocklist_elem) {
-        std::function<void(XMLElement*)> searchDirects = [&](XMLElement* elem) {
-            if (!elem) return;
-            if (std::string(elem->Name()) == "direct") {
+        // Busca em profundidade com pilha explícita (os directs ficam em
+        // qualquer nível dos pb_type); filhos empilhados em ordem inversa
+        // para manter a ordem do documento
+        std::vector<XMLElement*> stack(1, complexblocklist_elem);
+        std::vector<XMLElement*> children;
+        while (!stack.empty()) {
+            XMLElement* elem = stack.back();
+            stack.pop_back();
+            if (std::strcmp(elem->Name(), "direct") == 0) {
                 Direct dir;
                 dir.name = elem->Attribute("name") ? elem->Attribute("name") : "";
                 dir.from_pin = elem->Attribute("from_pin") ? elem->Attribute("from_pin") : "";
@@ -94,11 +100,12 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
                 dir.z_offset = elem->IntAttribute("z_offset", 0);
                 arch.directs.push_back(dir);
             }
+            children.clear();
             for (XMLElement* child = elem->FirstChildElement(); child; child = child->NextSiblingElement()) {
-                searchDirects(child);
+                children.push_back(child);
             }
-        };
-        searchDirects(complexblocklist_elem);
+            stack.insert(stack.end(), children.rbegin(), children.rend());
+        }
     }
     
     XMLElement* tiles_elem = root->FirstChildElement("tiles");
@@ -112,11 +119,14 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
             tile.type = tile.name;
             tile.height = tile_elem->IntAttribute("height", 1);
             tile.area = tile_elem->DoubleAttribute("area", 0.0);
+            tile.capacity = 1;
             tile.fc_in = 0.0;
             tile.fc_out = 0.0;
             
             XMLElement* subtile_elem = tile_elem->FirstChildElement("sub_tile");
             if (subtile_elem) {
+                tile.capacity = subtile_elem->IntAttribute("capacity", 1);
+                
                 XMLElement* fc_elem = subtile_elem->FirstChildElement("fc");
                 if (fc_elem) {
                     tile.fc_in = fc_elem->DoubleAttribute("in_val", 0.0);
@@ -130,6 +140,8 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
                     port.type = "input";
                     port.is_clock = false;
                     port.name = input_elem->Attribute("name") ? input_elem->Attribute("name") : "";
+                    port.equivalent = input_elem->Attribute("equivalent") &&
+                                      std::string(input_elem->Attribute("equivalent")) == "full";
                     port.num_pins = input_elem->IntAttribute("num_pins", 1);
                     tile.ports.push_back(port);
                 }
@@ -141,6 +153,8 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
                     port.type = "output";
                     port.is_clock = false;
                     port.name = output_elem->Attribute("name") ? output_elem->Attribute("name") : "";
+                    port.equivalent = output_elem->Attribute("equivalent") &&
+                                      std::string(output_elem->Attribute("equivalent")) == "full";
                     port.num_pins = output_elem->IntAttribute("num_pins", 1);
                     tile.ports.push_back(port);
                 }
@@ -151,6 +165,7 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
                     Port port;
                     port.type = "clock";
                     port.is_clock = true;
+                    port.equivalent = false;
                     port.name = clock_elem->Attribute("name") ? clock_elem->Attribute("name") : "";
                     port.num_pins = clock_elem->IntAttribute("num_pins", 1);
                     tile.ports.push_back(port);
@@ -160,5 +175,40 @@ FPGAArchitecture parse_architecture_xml(const std::string& filename) {
         }
     }
     
+    arch.layout.aspect_ratio = 1.0;
+    XMLElement* layout_elem = root->FirstChildElement("layout");
+    XMLElement* auto_layout_elem = layout_elem ? layout_elem->FirstChildElement("auto_layout") : nullptr;
+    if (auto_layout_elem) {
+        arch.layout.aspect_ratio = auto_layout_elem->DoubleAttribute("aspect_ratio", 1.0);
+        for (XMLElement* rule_elem = auto_layout_elem->FirstChildElement(); 
+             rule_elem; 
+             rule_elem = rule_elem->NextSiblingElement()) {
+            
+            GridRule rule;
+            rule.kind = rule_elem->Name();
+            rule.type = rule_elem->Attribute("type") ? rule_elem->Attribute("type") : "";
+            rule.priority = rule_elem->IntAttribute("priority", 0);
+            rule.startx = rule_elem->IntAttribute("startx", rule_elem->IntAttribute("x", 0));
+            rule.starty = rule_elem->IntAttribute("starty", rule_elem->IntAttribute("y", 0));
+            rule.repeatx = rule_elem->IntAttribute("repeatx", 0);
+            rule.repeaty = rule_elem->IntAttribute("repeaty", 0);
+            arch.layout.rules.push_back(rule);
+        }
+    }
+    
     return arch;
 }
+
+} // namespace
+
+FPGAArchitecture parse_architecture_xml(const std::string& filename) {
+    XMLDocument doc;
+    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS) return FPGAArchitecture();
+    return parse_document(doc);
+}
+
+FPGAArchitecture parse_architecture_text(const std::string& text) {
+    XMLDocument doc;
+    if (doc.Parse(text.data(), text.size()) != XML_SUCCESS) return FPGAArchitecture();
+    return parse_document(doc);
+}
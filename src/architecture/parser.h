@@ -6,4 +6,7 @@
 
 FPGAArchitecture parse_architecture_xml(const std::string& filename);
 
+// Mesmo parse, a partir do XML já carregado em memória
+FPGAArchitecture parse_architecture_text(const std::string& text);
+
 #endif
\ No newline at end of file
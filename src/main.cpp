@@ -1,31 +1,218 @@
 #include <iostream>
 #include <filesystem>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 #include "architecture/parser.h"
+#include "architecture/cache.h"
 #include "netlist/parser.h"
 #include "placement/parser.h"
 #include "routing/graph_builder.h"
 #include "routing/router.h"
+#include "routing/timing.h"
+#include "routing/eco.h"
+#include "routing/route_file.h"
+#include "routing/profiling.h"
 
 namespace fs = std::filesystem;
 
-int main() {
+// Rotas em arquivo .bin usam a variante binária; as demais, o .route texto
+static bool is_binary_route(const std::string& filename) {
+    return fs::path(filename).extension() == ".bin";
+}
+
+static void print_usage(std::ostream& out, const char* program) {
+    out << "Uso: " << program << " [opções]\n"
+        << "  --threads N          threads do build e do roteamento\n"
+        << "  --chan-width W       largura de canal\n"
+        << "  --graph-cache DIR    diretório do cache do grafo\n"
+        << "  --no-graph-cache     desativa o cache do grafo\n"
+        << "  --eco-net ARQ        netlist ECO\n"
+        << "  --eco-place ARQ      placement ECO\n"
+        << "  --route-in ARQ       rota anterior (.route ou .bin)\n"
+        << "  --route-out ARQ      rota de saída (.route ou .bin)\n"
+        << "  --profile ARQ        relatório de profiling em JSON\n"
+        << "  --quiet              não lista cada net roteada\n"
+        << "  --astar-fac F        peso do lookahead no A* (0 = Dijkstra)\n"
+        << "  --bidir-span N       span mínimo para busca bidirecional (requer --astar-fac 0)\n"
+        << "  --queue TIPO         fila do roteador (binary, 4ary, radix)\n"
+        << "  -h, --help           mostra esta ajuda\n";
+}
+
+int main(int argc, char** argv) {
     std::string data_dir = "../data";
+    RouterOptions router_options;
+    GraphBuildOptions graph_options;
+    std::string arch_file = data_dir + "/k6_frac_N10_mem32K_40nm.xml";
+    graph_options.cache_dir = "rrgraph_cache";
+    std::string net_file = data_dir + "/circuito_simples.net";
+    std::string place_file = data_dir + "/circuito_simples.place";
+    std::string eco_net_file, eco_place_file;
+    std::string route_in_file;
+    std::string route_out_file = "circuito_simples.route";
+    std::string profile_file;
     
-    auto fpga_arch = parse_architecture_xml(data_dir + "/k6_frac_N10_mem32K_40nm.xml");
-    auto nets = read_net_file(data_dir + "/circuito_simples.net");
-    auto placements = read_place_file(data_dir + "/circuito_simples.place");
+    // Opções de linha de comando
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            router_options.num_threads = std::max(1, std::atoi(argv[++i]));
+            graph_options.num_threads = router_options.num_threads;
+        } else if (std::strcmp(argv[i], "--chan-width") == 0 && i + 1 < argc) {
+            graph_options.channel_width = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--graph-cache") == 0 && i + 1 < argc) {
+            graph_options.cache_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-graph-cache") == 0) {
+            graph_options.cache_dir.clear();
+        } else if (std::strcmp(argv[i], "--eco-net") == 0 && i + 1 < argc) {
+            eco_net_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--eco-place") == 0 && i + 1 < argc) {
+            eco_place_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--route-in") == 0 && i + 1 < argc) {
+            route_in_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--route-out") == 0 && i + 1 < argc) {
+            route_out_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            router_options.log_nets = false;
+        } else if (std::strcmp(argv[i], "--astar-fac") == 0 && i + 1 < argc) {
+            router_options.astar_fac = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        } else if (std::strcmp(argv[i], "--bidir-span") == 0 && i + 1 < argc) {
+            router_options.bidir_min_span = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+            if (!parse_queue_kind(argv[++i], router_options.queue)) {
+                std::cout << "AVISO: fila " << argv[i] << " desconhecida (binary, 4ary, radix)\n";
+            }
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            print_usage(std::cout, argv[0]);
+            return 0;
+        } else {
+            // Opção desconhecida ou sem o valor esperado
+            std::cerr << "ERRO: opção inválida ou incompleta: " << argv[i] << "\n";
+            print_usage(std::cerr, argv[0]);
+            return 1;
+        }
+    }
+    
+    // Cada fase cronometrada no seu escopo
+    Profiler profiler;
+    FPGAArchitecture fpga_arch;
+    PackedNetlist netlist;
+    std::vector<Placement> placements;
+    {
+        ScopedTimer timer(profiler, "arch_parse");
+        // Mesmo diretório do cache do grafo, chaveado pelo hash do XML
+        fpga_arch = load_architecture(arch_file, graph_options.cache_dir, &graph_options.arch_hash);
+    }
+    {
+        ScopedTimer timer(profiler, "netlist_parse");
+        netlist = read_packed_netlist(net_file);
+    }
+    {
+        ScopedTimer timer(profiler, "placement_parse");
+        placements = read_place_file(place_file);
+    }
+    // Entradas ausentes ou ilegíveis chegam vazias dos parsers
+    if (fpga_arch.tiles.empty()) {
+        std::cerr << "ERRO: arquitetura " << arch_file << " ausente ou inválida\n";
+        return 1;
+    }
+    if (netlist.blocks.empty()) {
+        std::cerr << "ERRO: netlist " << net_file << " ausente ou inválido\n";
+        return 1;
+    }
+    if (placements.empty()) {
+        std::cerr << "ERRO: placement " << place_file << " ausente ou inválido\n";
+        return 1;
+    }
     
     // 1. Construir grafo
-    RoutingGraphBuilder builder;
-    RoutingGraph rr_graph = builder.buildGraph(fpga_arch, nets, placements);
+    RoutingGraphBuilder builder(graph_options);
+    RoutingGraph rr_graph;
+    {
+        ScopedTimer timer(profiler, "graph_build");
+        rr_graph = builder.buildGraph(fpga_arch, placements);
+    }
+    if (rr_graph.nodes.size() == 0) {
+        std::cerr << "ERRO: não foi possível construir o RR graph\n";
+        return 1;
+    }
     
     // 2. Mapear nets para nós físicos
     std::vector<Net> physical_nets;
-    builder.mapNetsToPhysicalNodes(nets, placements, fpga_arch, physical_nets, rr_graph);
+    {
+        ScopedTimer timer(profiler, "mapping");
+        builder.mapNetsToPhysicalNodes(netlist, placements, fpga_arch, physical_nets, rr_graph);
+    }
+    
+    // 3. Executar routing guiado por timing
+    TimingAnalyzer timing;
+    Router router(router_options);
+    router.setTimingAnalyzer(&timing);
+    std::vector<RouteTree> routes;
+    {
+        ScopedTimer timer(profiler, "routing");
+        timing.build(fpga_arch, netlist, physical_nets);
+        
+        // Rota anterior em arquivo: validada e completada incrementalmente
+        if (!route_in_file.empty()) {
+            routes = is_binary_route(route_in_file)
+                ? read_route_binary(route_in_file, rr_graph, physical_nets)
+                : read_route_file(route_in_file, rr_graph, physical_nets);
+            if (routes.empty()) {
+                std::cout << "AVISO: rota " << route_in_file << " inválida, roteando do zero\n";
+            } else {
+                apply_route_occupancy(rr_graph, routes);
+                routes = router.reroute(rr_graph, physical_nets, std::move(routes));
+            }
+        }
+        if (routes.empty()) {
+            routes = router.route(rr_graph, physical_nets);
+        }
+    }
+    
+    // 3b. ECO: rotear a nova versão do netlist/placement sobre a rota atual,
+    // no mesmo grid; só as nets alteradas (e as que conflitarem) são refeitas
+    if (!eco_net_file.empty() || !eco_place_file.empty()) {
+        ScopedTimer timer(profiler, "eco");
+        if (!eco_net_file.empty()) netlist = read_packed_netlist(eco_net_file);
+        if (!eco_place_file.empty()) placements = read_place_file(eco_place_file);
+        if (netlist.blocks.empty() || placements.empty()) {
+            std::cerr << "ERRO: entradas ECO ausentes ou inválidas ("
+                      << (netlist.blocks.empty() ? eco_net_file : eco_place_file) << ")\n";
+            return 1;
+        }
+        
+        std::vector<Net> eco_nets;
+        builder.mapNetsToPhysicalNodes(netlist, placements, fpga_arch, eco_nets, rr_graph);
+        EcoDiff diff = diff_nets(physical_nets, eco_nets);
+        std::cout << "\nECO: " << diff.num_changed << " nets alteradas, "
+                  << diff.removed.size() << " removidas\n";
+        
+        auto eco_routes = carry_over_routes(rr_graph, routes, diff);
+        timing.build(fpga_arch, netlist, eco_nets);
+        routes = router.reroute(rr_graph, eco_nets, std::move(eco_routes));
+        physical_nets.swap(eco_nets);
+    }
+    timing.exportTo(rr_graph.timing, physical_nets);
+    
+    if (!route_out_file.empty()) {
+        ScopedTimer timer(profiler, "route_write");
+        RouteFileInfo info;
+        info.placement_file = fs::path(eco_place_file.empty() ? place_file : eco_place_file).filename().string();
+        info.grid_width = builder.gridWidth();
+        info.grid_height = builder.gridHeight();
+        bool written = is_binary_route(route_out_file)
+            ? write_route_binary(route_out_file, physical_nets, routes)
+            : write_route_file(route_out_file, rr_graph, physical_nets, routes, info);
+        if (!written) {
+            std::cout << "AVISO: não foi possível gravar " << route_out_file << "\n";
+        }
+    }
     
-    // 3. Executar routing
-    Router router;
-    auto routes = router.route(rr_graph, physical_nets);
+    if (!profile_file.empty() && !write_profile_report(profile_file, profiler, router, physical_nets)) {
+        std::cout << "AVISO: não foi possível gravar " << profile_file << "\n";
+    }
     
     // 4. Estatísticas
     std::cout << "\n====== RESULTADOS DO ROUTING ======\n";
@@ -43,9 +230,12 @@ int main() {
     }
     
     std::cout << "\nEstatísticas:\n";
-    std::cout << "Nets totais: " << nets.size() << "\n";
+    std::cout << "Nets totais: " << netlist.nets.size() << "\n";
     std::cout << "Nets roteadas: " << routed_nets << "\n";
+    std::cout << "Roteamento legal: " << (router.isLegal() ? "sim" : "não")
+              << " (" << router.iterations() << " iterações)\n";
     std::cout << "Delay total: " << total_delay << " ns\n";
+    std::cout << "Caminho crítico: " << timing.criticalPathDelay() << " ns\n";
     std::cout << "Delay médio por net: " 
               << (routed_nets > 0 ? total_delay / routed_nets : 0) << " ns\n";
     
@@ -1,156 +1,525 @@
 #include "./parser.h"
-#include "tinyxml2.h"
-#include <map>
-#include <sstream>
-using namespace tinyxml2;
-
-std::vector<Net> read_net_file(const std::string& filename) {
-    std::vector<Net> nets;
-    XMLDocument doc;
-    if (doc.LoadFile(filename.c_str()) != XML_SUCCESS) return nets;
-    
-    XMLElement* root = doc.RootElement();
-    if (!root) return nets;
-    
-    std::map<std::string, int> block_name_to_id;
-    std::map<std::string, int> net_name_to_id;
-    std::map<std::string, std::string> block_type;
-    std::vector<std::string> net_source_blocks;
-    
-    int block_id_counter = 0;
-    for (XMLElement* block_elem = root->FirstChildElement("block"); 
-         block_elem; 
-         block_elem = block_elem->NextSiblingElement("block")) {
-        
-        const char* name_attr = block_elem->Attribute("name");
-        if (!name_attr) continue;
-        
-        std::string block_name = name_attr;
-        if (block_name == "open" || block_name.empty() || block_name == "circuito_simples.net") {
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Lista de portas de um bloco (<inputs>, <outputs>, <clocks>)
+enum PortDir : uint8_t { DIR_INPUT, DIR_OUTPUT, DIR_CLOCK, DIR_NONE };
+
+// Pino de cluster ligado a uma net (port/net são símbolos)
+struct TerminalRecord {
+    int port;
+    int pin;
+    int net;
+    PortDir dir;
+};
+
+// Cluster lido na passada, com nome, tipo e modo já internados.
+// Os terminais de todos os clusters ficam num vetor plano compartilhado
+struct BlockRecord {
+    int name;
+    int type;  // pb_type do topo: instance sem o índice
+    int mode;  // -1 se ausente
+    size_t terminals_begin, terminals_end;
+};
+
+// Bloco da hierarquia interna do cluster corrente (nó 0 = o próprio cluster)
+struct PbNode {
+    std::string_view instance;
+    int parent;
+};
+
+// Porta de um bloco interno com o texto cru da sua lista de pinos
+struct PbPort {
+    int node;
+    PortDir dir;
+    std::string_view name;
+    std::string_view text;
+};
+
+// Decodifica as entidades do XML (&lt; &gt; &amp; &quot; &apos; &#N; &#xN;)
+std::string decode_entities(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        size_t semi = text[i] == '&' ? text.find(';', i) : std::string_view::npos;
+        if (semi == std::string_view::npos) {
+            out += text[i];
             continue;
         }
-        
-        std::string instance = block_elem->Attribute("instance") ? block_elem->Attribute("instance") : "";
-        std::string mode = block_elem->Attribute("mode") ? block_elem->Attribute("mode") : "";
-        
-        if (instance.find("clb") != std::string::npos) {
-            block_type[block_name] = "clb";
-        } else if (instance.find("io") != std::string::npos) {
-            if (mode == "inpad") {
-                block_type[block_name] = "io_in";
-                net_source_blocks.push_back(block_name);
-            } else if (mode == "outpad") {
-                block_type[block_name] = "io_out";
-            } else {
-                block_type[block_name] = "io";
-            }
+        std::string_view entity = text.substr(i + 1, semi - i - 1);
+        if (entity == "lt") out += '<';
+        else if (entity == "gt") out += '>';
+        else if (entity == "amp") out += '&';
+        else if (entity == "quot") out += '"';
+        else if (entity == "apos") out += '\'';
+        else if (entity.size() > 1 && entity[0] == '#') {
+            bool hex = entity[1] == 'x' || entity[1] == 'X';
+            long code = std::strtol(std::string(entity.substr(hex ? 2 : 1)).c_str(), nullptr, hex ? 16 : 10);
+            out += static_cast<char>(code);
+        } else {
+            out.append(text.substr(i, semi - i + 1));
         }
-        
-        block_name_to_id[block_name] = block_id_counter++;
+        i = semi;
+    }
+    return out;
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Chama visit(pino, token) para cada token de uma lista de pinos separada
+// por espaços; visit retorna false para parar
+template <typename Visit>
+void for_each_token(std::string_view text, Visit&& visit) {
+    size_t i = 0;
+    for (int pin = 0; i < text.size(); ++pin) {
+        while (i < text.size() && is_space(text[i])) ++i;
+        size_t begin = i;
+        while (i < text.size() && !is_space(text[i])) ++i;
+        if (i == begin || !visit(pin, text.substr(begin, i - begin))) break;
     }
-    
-    for (const auto& block : block_name_to_id) {
-        if (block_type[block.first] == "clb") {
-            net_source_blocks.push_back(block.first);
+}
+
+// Token do pino index (vazio se faltar)
+std::string_view nth_token(std::string_view text, int index) {
+    std::string_view found;
+    for_each_token(text, [&](int pin, std::string_view token) {
+        if (pin == index) found = token;
+        return pin < index;
+    });
+    return found;
+}
+
+// Valor cru do atributo key na lista de atributos da tag; false se ausente
+bool find_attribute(std::string_view attrs, std::string_view key, std::string_view& value) {
+    size_t i = 0;
+    while (i < attrs.size()) {
+        while (i < attrs.size() && is_space(attrs[i])) ++i;
+        size_t name_begin = i;
+        while (i < attrs.size() && attrs[i] != '=' && !is_space(attrs[i])) ++i;
+        std::string_view name = attrs.substr(name_begin, i - name_begin);
+        while (i < attrs.size() && (is_space(attrs[i]) || attrs[i] == '=')) ++i;
+        if (i >= attrs.size()) return false;
+        char quote = attrs[i];
+        if (quote != '"' && quote != '\'') return false;
+        size_t close = attrs.find(quote, i + 1);
+        if (close == std::string_view::npos) return false;
+        if (name == key) {
+            value = attrs.substr(i + 1, close - i - 1);
+            return true;
         }
+        i = close + 1;
     }
-    
-    for (size_t i = 0; i < net_source_blocks.size(); i++) {
-        Net net;
-        net.id = i;
-        net.name = net_source_blocks[i];
-        net.driver = -1;
-        nets.push_back(net);
-        net_name_to_id[net_source_blocks[i]] = i;
-    }
-    
-    for (XMLElement* block_elem = root->FirstChildElement("block"); 
-         block_elem; 
-         block_elem = block_elem->NextSiblingElement("block")) {
-        
-        const char* block_name_attr = block_elem->Attribute("name");
-        if (!block_name_attr) continue;
-        
-        std::string current_block = block_name_attr;
-        if (current_block == "open" || current_block.empty() || 
-            block_name_to_id.find(current_block) == block_name_to_id.end()) {
-            continue;
+    return false;
+}
+
+// Leitura em uma passada: varre o texto do arquivo uma vez, guardando só
+// os clusters e os terminais das suas portas. Nomes viram índices numa
+// tabela de símbolos cujas chaves apontam para o próprio arquivo mapeado.
+// A hierarquia interna de cada cluster é mantida só até o fim dele, para
+// resolver as saídas até a primitiva que dirige a net
+class NetStreamParser {
+public:
+    NetStreamParser(const char* begin, const char* end) : cur_(begin), end_(end) {}
+
+    // false se o XML estiver malformado
+    bool parse();
+
+    // Nets por pino de cluster
+    PackedNetlist buildPackedNetlist() const;
+
+private:
+    bool parseTag();
+    bool skipPast(const char* terminator);
+    void onStartElement(std::string_view name, std::string_view attrs, bool self_closing);
+    void onEndElement();
+    void onText(std::string_view text);
+
+    // Resolve as saídas do cluster e descarta a sua hierarquia
+    void finishCluster();
+
+    // Net (símbolo) que chega por um token da lista de pinos de node,
+    // seguindo referências "inst[i].porta[p]->interconexão"; -1 se aberto
+    int resolveToken(int node, bool output, std::string_view raw, int depth);
+
+    // Token do pino pin da porta de node (lista de saídas ou de entradas/clocks)
+    std::string_view findPin(int node, bool output, std::string_view port, int pin) const;
+
+    // Índice do símbolo do texto cru do arquivo (entidades decodificadas)
+    int intern(std::string_view raw);
+
+    const char* cur_;
+    const char* end_;
+
+    std::vector<std::string_view> stack_;  // Elementos abertos
+    std::unordered_map<std::string_view, int> symbols_;
+    std::vector<std::string_view> symbol_names_;
+    std::deque<std::string> decoded_;      // Nomes com entidades (referências estáveis)
+
+    std::vector<BlockRecord> blocks_;
+    std::vector<TerminalRecord> terminals_;
+
+    // Cluster corrente
+    bool in_block_ = false;                // Dentro de um cluster válido
+    bool seen_lists_[3] = {};              // Só a primeira lista de cada tipo do cluster conta
+    PortDir list_dir_ = DIR_NONE;          // Lista de portas aberta
+    bool port_text_ = false;               // Primeiro filho de um <port> ainda não visto
+    PbPort pending_port_;
+    std::vector<PbNode> nodes_;
+    std::vector<PbPort> ports_;
+    std::vector<int> node_stack_;
+    std::vector<int> port_begin_, port_order_;    // Portas agrupadas por nó
+    std::vector<int> child_begin_, child_order_;  // Filhos agrupados por nó
+};
+
+int NetStreamParser::intern(std::string_view raw) {
+    std::string_view text = raw;
+    if (raw.find('&') != std::string_view::npos) {
+        decoded_.push_back(decode_entities(raw));
+        text = decoded_.back();
+    }
+    auto it = symbols_.find(text);
+    if (it != symbols_.end()) return it->second;
+    int id = static_cast<int>(symbol_names_.size());
+    symbols_.emplace(text, id);
+    symbol_names_.push_back(text);
+    return id;
+}
+
+bool NetStreamParser::skipPast(const char* terminator) {
+    size_t len = std::strlen(terminator);
+    const char* found = std::search(cur_, end_, terminator, terminator + len);
+    if (found == end_) return false;
+    cur_ = found + len;
+    return true;
+}
+
+bool NetStreamParser::parse() {
+    while (cur_ < end_) {
+        const char* lt = static_cast<const char*>(std::memchr(cur_, '<', end_ - cur_));
+        const char* text_end = lt ? lt : end_;
+        if (text_end > cur_) onText(std::string_view(cur_, text_end - cur_));
+        if (!lt) break;
+        cur_ = lt;
+        if (!parseTag()) return false;
+    }
+    return stack_.empty();
+}
+
+bool NetStreamParser::parseTag() {
+    auto startsWith = [&](const char* prefix) {
+        size_t len = std::strlen(prefix);
+        return static_cast<size_t>(end_ - cur_) >= len && std::memcmp(cur_, prefix, len) == 0;
+    };
+    if (startsWith("<?")) return skipPast("?>");
+    if (startsWith("<!--")) return skipPast("-->");
+    if (startsWith("<![CDATA[")) {
+        const char* text = cur_ + 9;
+        if (!skipPast("]]>")) return false;
+        onText(std::string_view(text, cur_ - 3 - text));
+        return true;
+    }
+    if (startsWith("<!")) return skipPast(">");
+
+    // Fim da tag, ignorando '>' dentro de valores de atributos
+    const char* p = cur_ + 1;
+    char quote = 0;
+    while (p < end_ && (quote || *p != '>')) {
+        if (quote) {
+            if (*p == quote) quote = 0;
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
         }
-        
-        XMLElement* inputs_elem = block_elem->FirstChildElement("inputs");
-        if (inputs_elem) {
-            for (XMLElement* port_elem = inputs_elem->FirstChildElement("port"); 
-                 port_elem; 
-                 port_elem = port_elem->NextSiblingElement("port")) {
-                
-                const char* port_text = port_elem->GetText();
-                if (port_text) {
-                    std::string content = port_text;
-                    std::istringstream iss(content);
-                    std::string token;
-                    
-                    while (iss >> token) {
-                        if (token == "open") continue;
-                        if (token.find('.') == std::string::npos && 
-                            token.find('[') == std::string::npos &&
-                            token.find("->") == std::string::npos) {
-                            
-                            if (net_name_to_id.find(token) != net_name_to_id.end()) {
-                                int net_idx = net_name_to_id[token];
-                                int block_idx = block_name_to_id[current_block];
-                                if (nets[net_idx].driver != block_idx) {
-                                    nets[net_idx].sinks.push_back(block_idx);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        ++p;
+    }
+    if (p >= end_) return false;
+    std::string_view tag(cur_ + 1, p - cur_ - 1);
+    cur_ = p + 1;
+
+    if (!tag.empty() && tag[0] == '/') {
+        std::string_view name = tag.substr(1);
+        while (!name.empty() && is_space(name.back())) name.remove_suffix(1);
+        if (stack_.empty() || stack_.back() != name) return false;
+        onEndElement();
+        stack_.pop_back();
+        return true;
+    }
+
+    bool self_closing = !tag.empty() && tag.back() == '/';
+    if (self_closing) tag.remove_suffix(1);
+    size_t name_end = 0;
+    while (name_end < tag.size() && !is_space(tag[name_end])) ++name_end;
+    if (name_end == 0) return false;
+    std::string_view name = tag.substr(0, name_end);
+
+    stack_.push_back(name);
+    onStartElement(name, tag.substr(name_end), self_closing);
+    if (self_closing) {
+        onEndElement();
+        stack_.pop_back();
+    }
+    return true;
+}
+
+void NetStreamParser::onStartElement(std::string_view name, std::string_view attrs, bool self_closing) {
+    const size_t depth = stack_.size();
+    port_text_ = false;
+
+    // Clusters: <block> filhos diretos da raiz
+    if (depth == 2 && name == "block") {
+        in_block_ = false;
+        std::string_view block_name;
+        if (!find_attribute(attrs, "name", block_name)) return;
+        if (block_name.empty() || block_name == "open") return;
+
+        std::string_view instance, mode;
+        find_attribute(attrs, "instance", instance);
+        bool has_mode = find_attribute(attrs, "mode", mode);
+        blocks_.push_back({intern(block_name), intern(instance.substr(0, instance.find('['))),
+                           has_mode ? intern(mode) : -1,
+                           terminals_.size(), terminals_.size()});
+
+        in_block_ = !self_closing;
+        std::fill(std::begin(seen_lists_), std::end(seen_lists_), false);
+        list_dir_ = DIR_NONE;
+        nodes_.assign(1, {instance, -1});
+        ports_.clear();
+        node_stack_.assign(1, 0);
+        return;
+    }
+    if (!in_block_) return;
+
+    const std::string_view parent = stack_[depth - 2];
+    if (name == "block") {
+        std::string_view instance;
+        find_attribute(attrs, "instance", instance);
+        node_stack_.push_back(static_cast<int>(nodes_.size()));
+        nodes_.push_back({instance, node_stack_[node_stack_.size() - 2]});
+        list_dir_ = DIR_NONE;
+    } else if (parent == "block" && (name == "inputs" || name == "outputs" || name == "clocks")) {
+        list_dir_ = name == "inputs" ? DIR_INPUT : name == "outputs" ? DIR_OUTPUT : DIR_CLOCK;
+        if (node_stack_.back() == 0) {
+            if (seen_lists_[list_dir_]) list_dir_ = DIR_NONE;
+            else seen_lists_[list_dir_] = true;
         }
-        
-        XMLElement* outputs_elem = block_elem->FirstChildElement("outputs");
-        if (outputs_elem) {
-            for (XMLElement* port_elem = outputs_elem->FirstChildElement("port"); 
-                 port_elem; 
-                 port_elem = port_elem->NextSiblingElement("port")) {
-                
-                const char* port_text = port_elem->GetText();
-                if (port_text) {
-                    std::string content = port_text;
-                    std::istringstream iss(content);
-                    std::string token;
-                    
-                    while (iss >> token) {
-                        if (token == "open") continue;
-                        if (token.find('.') == std::string::npos && 
-                            token.find('[') == std::string::npos &&
-                            token.find("->") == std::string::npos) {
-                            
-                            if (net_name_to_id.find(token) != net_name_to_id.end()) {
-                                int net_idx = net_name_to_id[token];
-                                int block_idx = block_name_to_id[current_block];
-                                nets[net_idx].driver = block_idx;
-                            }
-                        }
-                    }
-                }
-            }
+    } else if (name == "port" && list_dir_ != DIR_NONE && parent != "block") {
+        std::string_view port_name;
+        find_attribute(attrs, "name", port_name);
+        pending_port_ = {node_stack_.back(), list_dir_, port_name, std::string_view()};
+        port_text_ = !self_closing;
+    }
+}
+
+void NetStreamParser::onEndElement() {
+    const size_t depth = stack_.size();
+    const std::string_view name = stack_.back();
+    port_text_ = false;
+    if (!in_block_) return;
+
+    if (depth == 2) {
+        finishCluster();
+        in_block_ = false;
+    } else if (name == "block") {
+        node_stack_.pop_back();
+        list_dir_ = DIR_NONE;
+    } else if (name == "inputs" || name == "outputs" || name == "clocks") {
+        list_dir_ = DIR_NONE;
+    }
+}
+
+void NetStreamParser::onText(std::string_view text) {
+    // Só o texto antes do primeiro filho do <port> (como GetText())
+    if (!port_text_) return;
+    port_text_ = false;
+
+    pending_port_.text = text;
+    ports_.push_back(pending_port_);
+    if (pending_port_.node != 0) return;
+
+    // Pinos do próprio cluster cujo token já é o nome da net; referências
+    // (com "->") são resolvidas no fim do cluster
+    const int port = intern(pending_port_.name);
+    for_each_token(text, [&](int pin, std::string_view raw) {
+        if (raw == "open") return true;
+        std::string decoded;
+        std::string_view token = raw;
+        if (raw.find('&') != std::string_view::npos) {
+            decoded = decode_entities(raw);
+            token = decoded;
+        }
+        if (token != "open" && token.find("->") == std::string_view::npos) {
+            terminals_.push_back({port, pin, intern(raw), pending_port_.dir});
         }
+        return true;
+    });
+    blocks_.back().terminals_end = terminals_.size();
+}
+
+void NetStreamParser::finishCluster() {
+    // Portas e filhos agrupados por nó (counting sort), para as buscas da resolução
+    auto groupBy = [&](size_t count, auto&& key, std::vector<int>& begin, std::vector<int>& order) {
+        begin.assign(nodes_.size() + 1, 0);
+        for (size_t i = 0; i < count; ++i) begin[key(i) + 1]++;
+        for (size_t n = 0; n < nodes_.size(); ++n) begin[n + 1] += begin[n];
+        order.resize(count);
+        std::vector<int> cursor(begin.begin(), begin.end() - 1);
+        for (size_t i = 0; i < count; ++i) order[cursor[key(i)]++] = static_cast<int>(i);
+    };
+    groupBy(ports_.size(), [&](size_t i) { return ports_[i].node; }, port_begin_, port_order_);
+    groupBy(nodes_.size() - 1, [&](size_t i) { return nodes_[i + 1].parent; }, child_begin_, child_order_);
+    for (int& child : child_order_) ++child;
+
+    for (const PbPort& port : ports_) {
+        if (port.node != 0 || port.dir != DIR_OUTPUT) continue;
+        const int port_sym = intern(port.name);
+        for_each_token(port.text, [&](int pin, std::string_view raw) {
+            bool reference = raw.find("->") != std::string_view::npos ||
+                             raw.find("-&gt;") != std::string_view::npos;
+            int net = reference ? resolveToken(0, true, raw, 0) : -1;
+            if (net >= 0) terminals_.push_back({port_sym, pin, net, DIR_OUTPUT});
+            return true;
+        });
     }
-    
-    if (net_name_to_id.find("a") != net_name_to_id.end()) {
-        nets[net_name_to_id["a"]].driver = -1;
+    blocks_.back().terminals_end = terminals_.size();
+    nodes_.clear();
+    ports_.clear();
+}
+
+std::string_view NetStreamParser::findPin(int node, bool output, std::string_view port, int pin) const {
+    for (int i = port_begin_[node]; i < port_begin_[node + 1]; ++i) {
+        const PbPort& candidate = ports_[port_order_[i]];
+        if ((candidate.dir == DIR_OUTPUT) == output && candidate.name == port) {
+            return nth_token(candidate.text, pin);
+        }
     }
-    if (net_name_to_id.find("b") != net_name_to_id.end()) {
-        nets[net_name_to_id["b"]].driver = -1;
+    return std::string_view();
+}
+
+int NetStreamParser::resolveToken(int node, bool output, std::string_view raw, int depth) {
+    if (raw.empty() || raw == "open" || depth > 64) return -1;
+    std::string decoded;
+    std::string_view token = raw;
+    if (raw.find('&') != std::string_view::npos) {
+        decoded = decode_entities(raw);
+        token = decoded;
+    }
+    size_t arrow = token.find("->");
+    if (arrow == std::string_view::npos) return intern(raw);
+
+    // Origem "inst[i].porta[p]" (filho do contexto) ou "tipo.porta[p]" (o próprio contexto)
+    std::string_view source = token.substr(0, arrow);
+    size_t dot = source.find('.');
+    size_t open_bracket = source.rfind('[');
+    size_t close_bracket = source.rfind(']');
+    if (dot == std::string_view::npos || open_bracket == std::string_view::npos ||
+        open_bracket < dot || close_bracket == std::string_view::npos || close_bracket < open_bracket) {
+        return -1;
+    }
+    std::string_view instance = source.substr(0, dot);
+    std::string_view port = source.substr(dot + 1, open_bracket - dot - 1);
+    int pin = std::atoi(std::string(source.substr(open_bracket + 1, close_bracket - open_bracket - 1)).c_str());
+
+    // Saídas são dirigidas por filhos do próprio nó; entradas, pelo pai ou irmãos
+    int context = output ? node : nodes_[node].parent;
+    if (context < 0) return -1;
+    if (instance.find('[') == std::string_view::npos) {
+        return resolveToken(context, false, findPin(context, false, port, pin), depth + 1);
+    }
+    for (int i = child_begin_[context]; i < child_begin_[context + 1]; ++i) {
+        int child = child_order_[i];
+        if (nodes_[child].instance == instance) {
+            return resolveToken(child, true, findPin(child, true, port, pin), depth + 1);
+        }
     }
-    
-    std::vector<Net> valid_nets_only;
-    for (const auto& net : nets) {
-        if (net.driver != -1 || !net.sinks.empty()) {
-            valid_nets_only.push_back(net);
+    return -1;
+}
+
+// Blocos em ordem de documento; nets, portas e tipos numerados na ordem
+// em que aparecem nos terminais
+PackedNetlist NetStreamParser::buildPackedNetlist() const {
+    PackedNetlist netlist;
+    const size_t num_symbols = symbol_names_.size();
+    std::vector<int> type_id(num_symbols, -1);
+    std::vector<int> port_id(num_symbols, -1);
+    std::vector<int> net_id(num_symbols, -1);
+
+    netlist.blocks.reserve(blocks_.size());
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+        const BlockRecord& record = blocks_[b];
+        int& type = type_id[record.type];
+        if (type < 0) {
+            type = static_cast<int>(netlist.block_types.size());
+            netlist.block_types.emplace_back(symbol_names_[record.type]);
+        }
+        netlist.blocks.push_back({std::string(symbol_names_[record.name]), type,
+                                  record.mode >= 0 ? std::string(symbol_names_[record.mode]) : std::string()});
+
+        for (size_t t = record.terminals_begin; t < record.terminals_end; ++t) {
+            const TerminalRecord& terminal = terminals_[t];
+            int& port = port_id[terminal.port];
+            if (port < 0) {
+                port = static_cast<int>(netlist.port_names.size());
+                netlist.port_names.emplace_back(symbol_names_[terminal.port]);
+            }
+            int& net = net_id[terminal.net];
+            if (net < 0) {
+                net = static_cast<int>(netlist.nets.size());
+                netlist.nets.push_back({std::string(symbol_names_[terminal.net]), {-1, -1, -1}, {}});
+            }
+
+            NetPin pin{static_cast<int>(b), port, terminal.pin};
+            PackedNet& packed_net = netlist.nets[net];
+            if (terminal.dir != DIR_OUTPUT) {
+                packed_net.sinks.push_back(pin);
+            } else if (packed_net.driver.block < 0) {
+                packed_net.driver = pin;
+            }
         }
     }
-    
-    return valid_nets_only;
+    return netlist;
+}
+
+// Mapeia o arquivo e roda o parser; false se faltar ou estiver malformado
+template <typename Build>
+bool parse_mapped_file(const std::string& filename, Build&& build) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return false;
+    madvise(addr, size, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(addr);
+    NetStreamParser parser(data, data + size);
+    bool ok = parser.parse();
+    if (ok) build(parser);
+    munmap(addr, size);
+    return ok;
+}
+
+} // namespace
+
+PackedNetlist read_packed_netlist(const std::string& filename) {
+    PackedNetlist netlist;
+    parse_mapped_file(filename, [&](const NetStreamParser& parser) { netlist = parser.buildPackedNetlist(); });
+    return netlist;
 }
@@ -5,6 +5,11 @@
 #include <vector>
 #include <string>
 
-std::vector<Net> read_net_file(const std::string& filename);
+// Lê o .net empacotado numa única passada sobre o arquivo mapeado, sem
+// montar o DOM, com cada net resolvida até os pinos (bloco, porta, pino)
+// dos clusters; as saídas são seguidas pela hierarquia interna até a
+// primitiva que dirige a net. Retorna vazio se o arquivo faltar ou
+// estiver malformado
+PackedNetlist read_packed_netlist(const std::string& filename);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,7 @@
 #include "./parser.h"
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
 
 std::vector<Placement> read_place_file(const std::string& filename) {
     std::vector<Placement> placements;
@@ -15,9 +16,16 @@ std::vector<Placement> read_place_file(const std::string& filename) {
         
         std::istringstream iss(line);
         Placement place;
-        if (iss >> place.block_name >> place.x >> place.y >> place.subblock >> place.block_num) {
-            placements.push_back(place);
+        if (!(iss >> place.block_name >> place.x >> place.y >> place.subblock)) continue;
+        
+        // Colunas opcionais: camada (formato novo do VPR) e "#N", o índice
+        // do bloco no netlist
+        place.block_num = -1;
+        std::string column;
+        while (iss >> column) {
+            if (column[0] == '#') place.block_num = std::atoi(column.c_str() + 1);
         }
+        placements.push_back(place);
     }
     
     file.close();
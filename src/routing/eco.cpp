@@ -0,0 +1,62 @@
+#include "routing/eco.h"
+#include <string>
+#include <unordered_map>
+
+EcoDiff diff_nets(const std::vector<Net>& old_nets, const std::vector<Net>& new_nets) {
+    std::unordered_map<std::string, int> old_index;
+    old_index.reserve(old_nets.size());
+    for (size_t i = 0; i < old_nets.size(); ++i) {
+        old_index.emplace(old_nets[i].name, static_cast<int>(i));
+    }
+
+    EcoDiff diff;
+    diff.new_to_old.assign(new_nets.size(), -1);
+    diff.changed.assign(new_nets.size(), 1);
+    std::vector<char> matched(old_nets.size(), 0);
+    for (size_t n = 0; n < new_nets.size(); ++n) {
+        auto it = old_index.find(new_nets[n].name);
+        if (it != old_index.end() && !matched[it->second]) {
+            const Net& old_net = old_nets[it->second];
+            matched[it->second] = 1;
+            diff.new_to_old[n] = it->second;
+            diff.changed[n] = old_net.driver != new_nets[n].driver || old_net.sinks != new_nets[n].sinks;
+        }
+        diff.num_changed += diff.changed[n];
+    }
+    for (size_t i = 0; i < old_nets.size(); ++i) {
+        if (!matched[i]) diff.removed.push_back(static_cast<int>(i));
+    }
+    return diff;
+}
+
+std::vector<RouteTree> carry_over_routes(RoutingGraph& graph, std::vector<RouteTree>& old_routes,
+                                         const EcoDiff& diff) {
+    std::vector<RouteTree> routes(diff.changed.size());
+    std::vector<char> kept(old_routes.size(), 0);
+    for (size_t n = 0; n < routes.size(); ++n) {
+        int old = diff.new_to_old[n];
+        if (!diff.changed[n] && old >= 0 && old < static_cast<int>(old_routes.size()) &&
+            old_routes[old].routed) {
+            routes[n] = std::move(old_routes[old]);
+            kept[old] = 1;
+        } else {
+            routes[n].total_delay = 0.0f;
+            routes[n].routed = false;
+        }
+        routes[n].net_id = static_cast<int>(n);
+    }
+
+    // Ocupação das rotas descartadas sai do grafo
+    for (size_t i = 0; i < old_routes.size(); ++i) {
+        if (kept[i]) continue;
+        graph.occupancy.ripUp(old_routes[i]);
+        old_routes[i] = RouteTree();
+    }
+    return routes;
+}
+
+void apply_route_occupancy(RoutingGraph& graph, const std::vector<RouteTree>& routes) {
+    for (const auto& route : routes) {
+        graph.occupancy.commit(route);
+    }
+}
@@ -2,155 +2,947 @@
 #include <iostream>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <filesystem>
+#include "../../include/routing/thread_pool.h"
+#include "../../include/routing/graph_cache.h"
+
+namespace {
+
+// Lados do tile / switch block
+const int SIDE_TOP = 0;
+const int SIDE_RIGHT = 1;
+const int SIDE_BOTTOM = 2;
+const int SIDE_LEFT = 3;
+
+// Fios são quebrados nas posições onde (pos - 1 + offset) % L == 0
+bool isWireStart(int pos, const TrackInfo& track) {
+    return pos == 1 || (pos - 1 + track.offset) % track.length == 0;
+}
+
+int wireEnd(int pos, const TrackInfo& track, int max_pos) {
+    int end = pos + track.length - 1 - (pos - 1 + track.offset) % track.length;
+    return std::min(end, max_pos);
+}
+
+int findSwitch(const FPGAArchitecture& arch, const std::string& name) {
+    for (size_t i = 0; i < arch.switches.size(); ++i) {
+        if (arch.switches[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Quantidade de trilhas de um Fc (fração do canal ou valor absoluto)
+int fcTracks(double fc, int channel_width) {
+    int n = fc > 1.0 ? static_cast<int>(fc) : static_cast<int>(std::lround(fc * channel_width));
+    return std::max(1, std::min(channel_width, n));
+}
+
+} // namespace
 
 RoutingGraph RoutingGraphBuilder::buildGraph(
     const FPGAArchitecture& arch,
-    const std::vector<Net>& nets,
     const std::vector<Placement>& placements
+) {
+    // Grid mínimo que contém todos os blocos posicionados
+    int width = options_.grid_width;
+    int height = options_.grid_height;
+    if (width <= 0 || height <= 0) {
+        int max_x = 0, max_y = 0;
+        for (const auto& placement : placements) {
+            max_x = std::max(max_x, placement.x);
+            max_y = std::max(max_y, placement.y);
+        }
+        width = std::max(3, max_x + 1);
+        height = std::max(3, max_y + 1);
+
+        // aspect_ratio do auto_layout (largura / altura): cresce a dimensão
+        // que ficou curta, sem cortar nenhum bloco
+        double aspect = arch.layout.aspect_ratio;
+        if (aspect > 0.0) {
+            if (width < aspect * height) {
+                width = static_cast<int>(std::ceil(aspect * height));
+            } else {
+                height = std::max(height, static_cast<int>(std::ceil(width / aspect)));
+            }
+        }
+    }
+
+    return buildGraph(arch, width, height);
+}
+
+RoutingGraph RoutingGraphBuilder::buildGraph(
+    const FPGAArchitecture& arch,
+    int grid_width,
+    int grid_height
 ) {
     RoutingGraph graph;
-    
-    // 1. Criar nós fictícios para teste
-    createTestNodes(graph, nets);
-    
-    std::cout << "RRGraph built with " << graph.nodes.size() 
-              << " nodes and " << graph.edges.size() 
-              << " edges" << std::endl;
-    
+
+    // 1. Grid, trilhas e layout dos nós de cada tipo de tile
+    createGrid(arch, grid_width, grid_height);
+    createTracks(arch);
+
+    templates_.assign(arch.tiles.size(), TileTemplate());
+    for (size_t t = 0; t < arch.tiles.size(); ++t) {
+        const Tile& tile = arch.tiles[t];
+        TileTemplate& tmpl = templates_[t];
+        int offset = 0;
+        for (const auto& port : tile.ports) {
+            tmpl.port_pin_offset.push_back(offset);
+            offset += port.num_pins;
+        }
+        for (const auto& port : tile.ports) {
+            tmpl.port_class_offset.push_back(offset);
+            offset += port.equivalent ? 1 : port.num_pins;
+        }
+        tmpl.nodes_per_instance = offset;
+        tmpl.num_nodes = offset * std::max(1, tile.capacity);
+    }
+
+    // Coordenadas, ptc e capacidade precisam caber nos tipos compactos do
+    // RRNodeStore; valores truncados corromperiam o grafo e o cache
+    int max_ptc = channel_width_ - 1;
+    int max_capacity = 1;
+    for (size_t t = 0; t < arch.tiles.size(); ++t) {
+        max_ptc = std::max(max_ptc, templates_[t].num_nodes - 1);
+        for (const auto& port : arch.tiles[t].ports) {
+            if (port.equivalent) max_capacity = std::max(max_capacity, port.num_pins);
+        }
+    }
+    if (grid_width_ > RRNodeStore::MAX_COORD || grid_height_ > RRNodeStore::MAX_COORD ||
+        max_ptc > RRNodeStore::MAX_COORD || max_capacity > RRNodeStore::MAX_INDEX) {
+        std::cerr << "Erro: grid " << grid_width_ << "x" << grid_height_ << " com W=" << channel_width_
+                  << " excede os limites do RR graph (coordenadas e ptc até "
+                  << RRNodeStore::MAX_COORD << ", capacidade até " << RRNodeStore::MAX_INDEX << ")"
+                  << std::endl;
+        return graph;
+    }
+
+    tile_base_.assign(static_cast<size_t>(grid_width_) * grid_height_, -1);
+
+    // Faixas de linhas do grid; cada uma é gerada por uma tarefa do pool
+    int num_threads = std::max(1, options_.num_threads);
+    std::unique_ptr<ThreadPool> pool;
+    int num_bands = 1;
+    if (num_threads > 1) {
+        pool.reset(new ThreadPool(num_threads));
+        num_bands = std::min(grid_height_, num_threads * 4);
+    }
+    std::vector<int> band_row(num_bands + 1);
+    for (int b = 0; b <= num_bands; ++b) {
+        band_row[b] = static_cast<int>(static_cast<long>(grid_height_) * b / num_bands);
+    }
+    auto forEachBand = [&](const std::function<void(int)>& task) {
+        if (pool) {
+            pool->run(num_bands, [&](int b, int) { task(b); });
+        } else {
+            task(0);
+        }
+    };
+
+    // 2. Contagem de nós por linha e soma de prefixos: id global do 1o nó de cada linha
+    std::vector<int> row_base(grid_height_ + 1, 0);
+    forEachBand([&](int b) {
+        for (int y = band_row[b]; y < band_row[b + 1]; ++y) {
+            row_base[y + 1] = countRowNodes(y);
+        }
+    });
+    for (int y = 0; y < grid_height_; ++y) {
+        row_base[y + 1] += row_base[y];
+    }
+
+    // Grafo já gerado para esta arquitetura e grid: mapear o cache em vez de reconstruir
+    GraphCacheKey cache_key = {options_.arch_hash, grid_width_, grid_height_, channel_width_};
+    std::string cache_file;
+    if (!options_.cache_dir.empty() && cache_key.arch_hash != 0) {
+        cache_file = graph_cache_path(options_.cache_dir, cache_key);
+        if (load_graph_cache(cache_file, cache_key, graph)) {
+            if (graph.nodes.size() == static_cast<size_t>(row_base[grid_height_])) {
+                // Só a base dos tiles é usada depois da construção (mapeamento das nets)
+                for (int y = 0; y < grid_height_; ++y) {
+                    int next_id = row_base[y];
+                    for (int x = 0; x < grid_width_; ++x) {
+                        const GridCell& cell = grid_[y * grid_width_ + x];
+                        if (cell.tile >= 0 && cell.y_offset == 0) {
+                            tile_base_[y * grid_width_ + x] = next_id;
+                            next_id += templates_[cell.tile].num_nodes;
+                        }
+                    }
+                }
+                std::cout << "RRGraph loaded from " << cache_file << " with "
+                          << graph.nodes.size() << " nodes and " << graph.numEdges()
+                          << " edges" << std::endl;
+                return graph;
+            }
+            graph = RoutingGraph();
+        }
+    }
+
+    // Nomes internados antes da geração paralela
+    for (size_t t = 0; t < arch.tiles.size(); ++t) {
+        const Tile& tile = arch.tiles[t];
+        TileTemplate& tmpl = templates_[t];
+        tmpl.node_names.clear();
+        for (const auto& port : tile.ports) {
+            for (int pin_idx = 0; pin_idx < port.num_pins; ++pin_idx) {
+                tmpl.node_names.push_back(graph.nodes.internName(port.name + "[" + std::to_string(pin_idx) + "]"));
+            }
+        }
+        for (const auto& port : tile.ports) {
+            int name = graph.nodes.internName(tile.name + (port.type == "output" ? "_SOURCE" : "_SINK"));
+            tmpl.node_names.insert(tmpl.node_names.end(), port.equivalent ? 1 : port.num_pins, name);
+        }
+    }
+    chanx_name_ = graph.nodes.internName("CHANX");
+    chany_name_ = graph.nodes.internName("CHANY");
+
+    // R/C dos fios por segmento e comprimento (fios cortados na borda são mais curtos)
+    wire_rc_.assign(arch.segments.size(), std::vector<int>());
+    for (size_t s = 0; s < arch.segments.size(); ++s) {
+        const Segment& segment = arch.segments[s];
+        for (int length = 1; length <= std::max(1, segment.length); ++length) {
+            wire_rc_[s].push_back(graph.nodes.internRC(static_cast<float>(segment.Rmetal * length),
+                                                       static_cast<float>(segment.Cmetal * length)));
+        }
+    }
+
+    // Nomes e pares R/C são indexados por uint16 em cada nó
+    const size_t max_entries = static_cast<size_t>(RRNodeStore::MAX_INDEX) + 1;
+    if (graph.nodes.names.size() > max_entries || graph.nodes.rc_data.size() > max_entries) {
+        std::cerr << "Erro: " << graph.nodes.names.size() << " nomes e " << graph.nodes.rc_data.size()
+                  << " pares R/C excedem o limite do RR graph (" << max_entries << ")" << std::endl;
+        return RoutingGraph();
+    }
+
+    size_t channel_slots = static_cast<size_t>(grid_width_) * grid_height_ * channel_width_;
+    chanx_wire_.assign(channel_slots, -1);
+    chany_wire_.assign(channel_slots, -1);
+
+    // 3. Nós linha a linha: tiles com raiz na linha, depois os fios que começam
+    // nela. Cada faixa escreve só no seu trecho de graph.nodes e das tabelas
+    graph.nodes.resize(row_base[grid_height_]);
+    forEachBand([&](int b) {
+        for (int y = band_row[b]; y < band_row[b + 1]; ++y) {
+            int next_id = row_base[y];
+            for (int x = 0; x < grid_width_; ++x) {
+                const GridCell& cell = grid_[y * grid_width_ + x];
+                if (cell.tile >= 0 && cell.y_offset == 0) {
+                    createTileNodes(arch.tiles[cell.tile], x, y, graph, next_id);
+                }
+            }
+            createChannelNodes(arch, y, graph, next_id);
+        }
+    });
+
+    // 4. Arestas: blocos de conexão e switch blocks de cada linha, em buffers por faixa
+    std::vector<std::vector<RREdge>> band_edges(num_bands);
+    forEachBand([&](int b) {
+        for (int y = band_row[b]; y < band_row[b + 1]; ++y) {
+            createPinConnections(arch, graph, y, band_edges[b]);
+            createSwitchConnections(arch, graph, y, band_edges[b]);
+        }
+    });
+    createDirectConnections(arch, band_edges.back());
+
+    // 5. Congelar adjacência em CSR para o roteador, faixa a faixa
+    std::vector<int> band_begin(num_bands);
+    for (int b = 0; b < num_bands; ++b) {
+        band_begin[b] = row_base[band_row[b]];
+    }
+    graph.freeze(band_edges, band_begin, pool.get());
+
+    if (!cache_file.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(options_.cache_dir, error);
+        if (!save_graph_cache(cache_file, graph, cache_key)) {
+            std::cerr << "Aviso: não foi possível gravar o cache " << cache_file << std::endl;
+        }
+    }
+
+    std::cout << "RRGraph built with " << graph.nodes.size()
+              << " nodes and " << graph.numEdges()
+              << " edges (grid " << grid_width_ << "x" << grid_height_
+              << ", W=" << channel_width_ << ")" << std::endl;
+
     return graph;
 }
 
-void RoutingGraphBuilder::createTestNodes(RoutingGraph& graph, const std::vector<Net>& nets) {
-    // Criar nós de teste conectados (grid 3x3 fictício)
-    int node_id = 0;
-    
-    // Criar 20 nós fictícios para teste
-    for (int i = 0; i < 20; ++i) {
-        RRNode node;
-        node.id = node_id++;
-        node.type = (i % 2 == 0) ? RRNodeType::IPIN : RRNodeType::CHANX;
-        node.x = i % 5;
-        node.y = i / 5;
-        node.capacity = 1;
-        node.used = 0;
-        node.base_cost = 1.0f;
-        node.delay = 0.1f + (i * 0.02f);  // Delays variados
-        node.name = "TEST_NODE_" + std::to_string(i);
-        
-        graph.addNode(node);
-    }
-    
-    // Criar arestas de conexão
-    for (int i = 0; i < 19; ++i) {
-        RREdge edge;
-        edge.from_node = i;
-        edge.to_node = i + 1;
-        edge.switch_id = 0;
-        edge.delay = 0.05f;
-        graph.addEdge(edge);
-    }
-    
-    // Adicionar algumas conexões cruzadas
-    graph.addEdge({0, 5, 0, 0.05f});
-    graph.addEdge({5, 10, 0, 0.05f});
-    graph.addEdge({10, 15, 0, 0.05f});
+void RoutingGraphBuilder::createGrid(const FPGAArchitecture& arch, int grid_width, int grid_height) {
+    grid_width_ = grid_width;
+    grid_height_ = grid_height;
+    grid_.assign(static_cast<size_t>(grid_width) * grid_height, GridCell{-1, 0});
+
+    std::unordered_map<std::string, int> tile_index;
+    for (size_t t = 0; t < arch.tiles.size(); ++t) {
+        tile_index[arch.tiles[t].name] = static_cast<int>(t);
+    }
+
+    // Sem <auto_layout>: preencher tudo com o primeiro tile
+    std::vector<GridRule> rules = arch.layout.rules;
+    if (rules.empty() && !arch.tiles.empty()) {
+        rules.push_back({"fill", arch.tiles[0].name, 0, 0, 0, 0, 0});
+    }
+    std::stable_sort(rules.begin(), rules.end(), [](const GridRule& a, const GridRule& b) {
+        return a.priority < b.priority;
+    });
+
+    // Remove um tile inteiro (todas as suas células)
+    auto clearTile = [&](int x, int y) {
+        GridCell& cell = grid_[y * grid_width + x];
+        if (cell.tile < 0) return;
+        int root_y = y - cell.y_offset;
+        int height = arch.tiles[cell.tile].height;
+        for (int dy = 0; dy < height && root_y + dy < grid_height; ++dy) {
+            grid_[(root_y + dy) * grid_width + x] = GridCell{-1, 0};
+        }
+    };
+
+    // Regras de maior prioridade sobrescrevem as anteriores
+    auto place = [&](int tile, int x, int y) {
+        if (x < 0 || x >= grid_width || y < 0 || y >= grid_height) return;
+        int height = tile >= 0 ? std::max(1, arch.tiles[tile].height) : 1;
+        if (y + height > grid_height) return;
+        for (int dy = 0; dy < height; ++dy) {
+            clearTile(x, y + dy);
+        }
+        for (int dy = 0; dy < height; ++dy) {
+            grid_[(y + dy) * grid_width + x] = GridCell{tile, dy};
+        }
+    };
+
+    for (const auto& rule : rules) {
+        int tile = -1;
+        auto it = tile_index.find(rule.type);
+        if (it != tile_index.end()) {
+            tile = it->second;
+        } else if (rule.type != "EMPTY") {
+            continue;
+        }
+        int step_y = tile >= 0 ? std::max(1, arch.tiles[tile].height) : 1;
+
+        if (rule.kind == "fill") {
+            for (int x = 0; x < grid_width; ++x) {
+                for (int y = 0; y + step_y <= grid_height; y += step_y) place(tile, x, y);
+            }
+        } else if (rule.kind == "perimeter") {
+            for (int x = 0; x < grid_width; ++x) {
+                place(tile, x, 0);
+                place(tile, x, grid_height - step_y);
+            }
+            for (int y = 1; y < grid_height - 1; ++y) {
+                place(tile, 0, y);
+                place(tile, grid_width - 1, y);
+            }
+        } else if (rule.kind == "corners") {
+            place(tile, 0, 0);
+            place(tile, grid_width - 1, 0);
+            place(tile, 0, grid_height - step_y);
+            place(tile, grid_width - 1, grid_height - step_y);
+        } else if (rule.kind == "col") {
+            for (int x = rule.startx; x < grid_width; x += rule.repeatx) {
+                for (int y = rule.starty; y + step_y <= grid_height; y += step_y) place(tile, x, y);
+                if (rule.repeatx <= 0) break;
+            }
+        } else if (rule.kind == "row") {
+            for (int y = rule.starty; y < grid_height; y += rule.repeaty) {
+                for (int x = rule.startx; x < grid_width; ++x) place(tile, x, y);
+                if (rule.repeaty <= 0) break;
+            }
+        } else if (rule.kind == "single") {
+            place(tile, rule.startx, rule.starty);
+        }
+    }
+}
+
+void RoutingGraphBuilder::createTracks(const FPGAArchitecture& arch) {
+    channel_width_ = std::max(1, options_.channel_width);
+    tracks_.clear();
+    segment_switch_.clear();
+    ipin_switch_ = findSwitch(arch, arch.device.connection_block_switch);
+
+    // Sem segmentos: fios bidirecionais de comprimento 1
+    std::vector<Segment> segments = arch.segments;
+    if (segments.empty()) {
+        segments.push_back({1.0, 1, "bidir", 0.0, 0.0, ""});
+    }
+
+    double total_freq = 0.0;
+    for (const auto& seg : segments) total_freq += std::max(0.0, seg.freq);
+    if (total_freq <= 0.0) total_freq = 1.0;
+
+    // Trilhas por segmento proporcionais a freq; unidirecionais em pares INC/DEC
+    std::vector<int> counts(segments.size(), 0);
+    int assigned = 0;
+    for (size_t s = 0; s < segments.size(); ++s) {
+        int n = static_cast<int>(channel_width_ * std::max(0.0, segments[s].freq) / total_freq);
+        if (segments[s].type == "unidir") n -= n % 2;
+        counts[s] = n;
+        assigned += n;
+    }
+    // Sobra do arredondamento, do último segmento para trás; unidirecionais
+    // só recebem pares. Se restar uma trilha (só há segmentos unidirecionais
+    // e W é ímpar), o canal cresce uma trilha para completar o par
+    int remainder = channel_width_ - assigned;
+    for (size_t s = segments.size(); s-- > 0 && remainder > 0;) {
+        int extra = segments[s].type == "unidir" ? remainder - remainder % 2 : remainder;
+        counts[s] += extra;
+        remainder -= extra;
+    }
+    if (remainder > 0) {
+        counts.back() += remainder + 1;
+        channel_width_ += 1;
+    }
+
+    for (size_t s = 0; s < segments.size(); ++s) {
+        const Segment& seg = segments[s];
+        bool unidir = seg.type == "unidir";
+        int length = std::max(1, seg.length);
+        segment_switch_.push_back(findSwitch(arch, seg.mux_name));
+
+        for (int i = 0; i < counts[s]; ++i) {
+            TrackInfo track;
+            track.segment = static_cast<int>(s);
+            track.length = length;
+            track.offset = (unidir ? i / 2 : i) % length;
+            track.direction = unidir ? (i % 2 == 0 ? 1 : -1) : 0;
+            tracks_.push_back(track);
+        }
+    }
+}
+
+int RoutingGraphBuilder::countRowNodes(int y) const {
+    int count = 0;
+    for (int x = 0; x < grid_width_; ++x) {
+        const GridCell& cell = grid_[y * grid_width_ + x];
+        if (cell.tile >= 0 && cell.y_offset == 0) count += templates_[cell.tile].num_nodes;
+    }
+
+    // Mesma regra de quebra dos fios de createChannelNodes
+    if (y <= grid_height_ - 2) {
+        for (int x = 1; x <= grid_width_ - 2; ++x) {
+            for (int t = 0; t < channel_width_; ++t) {
+                if (isWireStart(x, tracks_[t])) ++count;
+            }
+        }
+    }
+    if (y >= 1 && y <= grid_height_ - 2) {
+        int starts = 0;
+        for (int t = 0; t < channel_width_; ++t) {
+            if (isWireStart(y, tracks_[t])) ++starts;
+        }
+        count += starts * (grid_width_ - 1);
+    }
+    return count;
 }
 
 void RoutingGraphBuilder::createTileNodes(
     const Tile& tile,
-    int x, 
+    int x,
     int y,
+    RoutingGraph& graph,
+    int& next_id
+) {
+    const GridCell& cell = grid_[y * grid_width_ + x];
+    const TileTemplate& tmpl = templates_[cell.tile];
+    tile_base_[y * grid_width_ + x] = next_id;
+
+    RRNode node;
+    node.x = x;
+    node.y = y;
+    node.x_low = node.x_high = x;
+    node.y_low = y;
+    node.y_high = y + std::max(1, tile.height) - 1;
+    node.delay = 0.0f;
+
+    for (int z = 0; z < std::max(1, tile.capacity); ++z) {
+        // Pinos
+        for (size_t p = 0; p < tile.ports.size(); ++p) {
+            const Port& port = tile.ports[p];
+            bool output = port.type == "output";
+            for (int pin_idx = 0; pin_idx < port.num_pins; ++pin_idx) {
+                node.id = next_id;
+                node.type = output ? RRNodeType::OPIN : RRNodeType::IPIN;
+                node.ptc = z * tmpl.nodes_per_instance + tmpl.port_pin_offset[p] + pin_idx;
+                node.capacity = 1;
+                node.base_cost = output ? 1.0f : 0.95f;
+                graph.nodes.set(next_id++, node, tmpl.node_names[node.ptc - z * tmpl.nodes_per_instance]);
+            }
+        }
+
+        // Classes: portas equivalentes compartilham um SOURCE/SINK
+        for (size_t p = 0; p < tile.ports.size(); ++p) {
+            const Port& port = tile.ports[p];
+            bool output = port.type == "output";
+            int num_classes = port.equivalent ? 1 : port.num_pins;
+            for (int c = 0; c < num_classes; ++c) {
+                node.id = next_id;
+                node.type = output ? RRNodeType::SOURCE : RRNodeType::SINK;
+                node.ptc = z * tmpl.nodes_per_instance + tmpl.port_class_offset[p] + c;
+                node.capacity = port.equivalent ? port.num_pins : 1;
+                node.base_cost = output ? 1.0f : 0.0f;
+                graph.nodes.set(next_id++, node, tmpl.node_names[node.ptc - z * tmpl.nodes_per_instance]);
+            }
+        }
+    }
+}
+
+void RoutingGraphBuilder::createChannelNodes(
     const FPGAArchitecture& arch,
-    RoutingGraph& graph
+    int y,
+    RoutingGraph& graph,
+    int& next_id
 ) {
-    // Implementação simplificada - criar nós básicos para cada porta
-    for (const auto& port : tile.ports) {
-        for (int pin_idx = 0; pin_idx < port.num_pins; ++pin_idx) {
-            RRNode node;
-            node.id = graph.nodes.size();
-            
-            // Determinar tipo
-            if (port.type == "input") {
-                node.type = RRNodeType::IPIN;
-            } else if (port.type == "output") {
-                node.type = RRNodeType::OPIN;
-            } else if (port.type == "clock") {
-                node.type = RRNodeType::IPIN;
-            } else {
-                node.type = RRNodeType::VERTEX;
-            }
-            
-            node.x = x;
-            node.y = y;
-            node.capacity = 1;
-            node.used = 0;
-            node.base_cost = 1.0f;
-            node.delay = 0.1f;
-            node.name = tile.name + "_" + port.name;
-            
-            if (port.num_pins > 1) {
-                node.name += "[" + std::to_string(pin_idx) + "]";
-            }
-            
-            graph.addNode(node);
-            
-            // Armazenar mapeamento
-            std::string pin_key = port.name;
-            if (port.num_pins > 1) {
-                pin_key += "[" + std::to_string(pin_idx) + "]";
-            }
-            pin_node_map_[std::make_tuple(x, y, tile.name, pin_key)] = node.id;
-        }
-    }
-    
-    // Criar nós SOURCE e SINK básicos
-    RRNode source_node;
-    source_node.id = graph.nodes.size();
-    source_node.type = RRNodeType::SOURCE;
-    source_node.x = x;
-    source_node.y = y;
-    source_node.capacity = 1;
-    source_node.used = 0;
-    source_node.base_cost = 1.0f;
-    source_node.delay = 0.0f;
-    source_node.name = tile.name + "_SOURCE";
-    graph.addNode(source_node);
-    
-    RRNode sink_node;
-    sink_node.id = graph.nodes.size();
-    sink_node.type = RRNodeType::SINK;
-    sink_node.x = x;
-    sink_node.y = y;
-    sink_node.capacity = 1;
-    sink_node.used = 0;
-    sink_node.base_cost = 1.0f;
-    sink_node.delay = 0.0f;
-    sink_node.name = tile.name + "_SINK";
-    graph.addNode(sink_node);
+    const int W = grid_width_;
+    const int H = grid_height_;
+
+    auto makeWire = [&](RRNodeType type, int x_low, int y_low, int x_high, int y_high, int t) {
+        const TrackInfo& track = tracks_[t];
+        int length = (x_high - x_low) + (y_high - y_low) + 1;
+        double r = 0.0, c = 0.0;
+        if (track.segment < static_cast<int>(arch.segments.size())) {
+            r = arch.segments[track.segment].Rmetal * length;
+            c = arch.segments[track.segment].Cmetal * length;
+        }
+
+        RRNode node;
+        node.id = next_id;
+        node.type = type;
+        node.x = x_low;
+        node.y = y_low;
+        node.x_low = x_low;
+        node.y_low = y_low;
+        node.x_high = x_high;
+        node.y_high = y_high;
+        node.ptc = t;
+        node.capacity = 1;
+        node.base_cost = 1.0f;
+        node.delay = static_cast<float>(0.5 * r * c * 1e9);  // Elmore do fio, em ns
+        graph.nodes.set(next_id, node, type == RRNodeType::CHANX ? chanx_name_ : chany_name_);
+        if (track.segment < static_cast<int>(wire_rc_.size()) &&
+            length <= static_cast<int>(wire_rc_[track.segment].size())) {
+            graph.nodes.rc_index[next_id] = static_cast<uint16_t>(wire_rc_[track.segment][length - 1]);
+        }
+        return next_id++;
+    };
+
+    // CHANX do canal acima da linha y: x em [1, W-2]
+    if (y <= H - 2) {
+        for (int x = 1; x <= W - 2; ++x) {
+            for (int t = 0; t < channel_width_; ++t) {
+                if (!isWireStart(x, tracks_[t])) continue;
+                int end = wireEnd(x, tracks_[t], W - 2);
+                int id = makeWire(RRNodeType::CHANX, x, y, end, y, t);
+                for (int xi = x; xi <= end; ++xi) {
+                    chanx_wire_[(static_cast<size_t>(y) * W + xi) * channel_width_ + t] = id;
+                }
+            }
+        }
+    }
+
+    // CHANY que começam na linha y: canais x em [0, W-2], y em [1, H-2]
+    if (y >= 1 && y <= H - 2) {
+        for (int x = 0; x <= W - 2; ++x) {
+            for (int t = 0; t < channel_width_; ++t) {
+                if (!isWireStart(y, tracks_[t])) continue;
+                int end = wireEnd(y, tracks_[t], H - 2);
+                int id = makeWire(RRNodeType::CHANY, x, y, x, end, t);
+                for (int yi = y; yi <= end; ++yi) {
+                    chany_wire_[(static_cast<size_t>(yi) * W + x) * channel_width_ + t] = id;
+                }
+            }
+        }
+    }
+}
+
+int RoutingGraphBuilder::chanxWire(int x, int y, int track) const {
+    if (x < 1 || x > grid_width_ - 2 || y < 0 || y > grid_height_ - 2) return -1;
+    return chanx_wire_[(static_cast<size_t>(y) * grid_width_ + x) * channel_width_ + track];
+}
+
+int RoutingGraphBuilder::chanyWire(int x, int y, int track) const {
+    if (x < 0 || x > grid_width_ - 2 || y < 1 || y > grid_height_ - 2) return -1;
+    return chany_wire_[(static_cast<size_t>(y) * grid_width_ + x) * channel_width_ + track];
+}
+
+int RoutingGraphBuilder::pinSide(int x, int y, int pin) const {
+    // Tiles de borda só enxergam o canal interno
+    if (x == 0) return SIDE_RIGHT;
+    if (x == grid_width_ - 1) return SIDE_LEFT;
+    if (y == 0) return SIDE_TOP;
+    if (y == grid_height_ - 1) return SIDE_BOTTOM;
+    return pin % 4;
+}
+
+int RoutingGraphBuilder::pinNode(int x, int y, int z, int port, int pin) const {
+    const GridCell& cell = grid_[y * grid_width_ + x];
+    const TileTemplate& tmpl = templates_[cell.tile];
+    return tile_base_[y * grid_width_ + x] + z * tmpl.nodes_per_instance
+         + tmpl.port_pin_offset[port] + pin;
+}
+
+int RoutingGraphBuilder::classNode(const FPGAArchitecture& arch, int x, int y, int z, int port, int pin) const {
+    const GridCell& cell = grid_[y * grid_width_ + x];
+    const TileTemplate& tmpl = templates_[cell.tile];
+    bool equivalent = arch.tiles[cell.tile].ports[port].equivalent;
+    return tile_base_[y * grid_width_ + x] + z * tmpl.nodes_per_instance
+         + tmpl.port_class_offset[port] + (equivalent ? 0 : pin);
+}
+
+bool RoutingGraphBuilder::locateBlock(const FPGAArchitecture& arch, const Placement& placement,
+                                      int& x, int& y, int& z) const {
+    x = placement.x;
+    y = placement.y;
+    if (x < 0 || x >= grid_width_ || y < 0 || y >= grid_height_) return false;
+    const GridCell& cell = grid_[y * grid_width_ + x];
+    if (cell.tile < 0) return false;
+    y -= cell.y_offset;
+    z = placement.subblock % std::max(1, arch.tiles[cell.tile].capacity);
+    return true;
+}
+
+float RoutingGraphBuilder::wireEdgeDelay(const FPGAArchitecture& arch, int sw, int track) const {
+    if (sw < 0) return 0.0f;
+    const Switch& s = arch.switches[sw];
+    double c_wire = 0.0;
+    int segment = tracks_[track].segment;
+    if (segment < static_cast<int>(arch.segments.size())) {
+        c_wire = arch.segments[segment].Cmetal * tracks_[track].length;
+    }
+    return static_cast<float>((s.Tdel + s.R * (c_wire + s.Cout)) * 1e9);
+}
+
+void RoutingGraphBuilder::createPinConnections(
+    const FPGAArchitecture& arch,
+    const RoutingGraph& graph,
+    int y,
+    std::vector<RREdge>& edges
+) const {
+    float ipin_delay = ipin_switch_ >= 0 ? static_cast<float>(arch.switches[ipin_switch_].Tdel * 1e9) : 0.0f;
+    std::vector<int> candidates;
+
+    for (int x = 0; x < grid_width_; ++x) {
+        if (tile_base_[y * grid_width_ + x] < 0) continue;
+        const Tile& tile = arch.tiles[grid_[y * grid_width_ + x].tile];
+        const TileTemplate& tmpl = templates_[grid_[y * grid_width_ + x].tile];
+        int n_in = fcTracks(tile.fc_in, channel_width_);
+        int n_out = fcTracks(tile.fc_out, channel_width_);
+        int y_top = y + std::max(1, tile.height) - 1;
+
+        for (int z = 0; z < std::max(1, tile.capacity); ++z) {
+            for (size_t p = 0; p < tile.ports.size(); ++p) {
+                const Port& port = tile.ports[p];
+                bool output = port.type == "output";
+
+                for (int pin_idx = 0; pin_idx < port.num_pins; ++pin_idx) {
+                    int pin = pinNode(x, y, z, p, pin_idx);
+                    int cls = classNode(arch, x, y, z, p, pin_idx);
+                    int pin_number = z * tmpl.nodes_per_instance + tmpl.port_pin_offset[p] + pin_idx;
+
+                    // Canal do lado do pino; se não existir, tenta o próximo lado
+                    bool horizontal = false;
+                    int cx = -1, cy = -1, pos = 0;
+                    int side = pinSide(x, y, pin_number);
+                    for (int attempt = 0; attempt < 4; ++attempt, side = (side + 1) % 4) {
+                        if (side == SIDE_TOP) { horizontal = true; cx = x; cy = y_top; }
+                        else if (side == SIDE_BOTTOM) { horizontal = true; cx = x; cy = y - 1; }
+                        else if (side == SIDE_RIGHT) { horizontal = false; cx = x; cy = y; }
+                        else { horizontal = false; cx = x - 1; cy = y; }
+                        int probe = horizontal ? chanxWire(cx, cy, 0) : chanyWire(cx, cy, 0);
+                        if (probe >= 0) break;
+                        cx = -1;
+                    }
+                    pos = horizontal ? x : y;
+
+                    if (output) {
+                        edges.push_back({cls, pin, -1, 0.0f});
+                        if (cx < 0) continue;
+
+                        // OPIN alcança os fios que podem ser dirigidos nesta posição
+                        candidates.clear();
+                        for (int t = 0; t < channel_width_; ++t) {
+                            int wire = horizontal ? chanxWire(cx, cy, t) : chanyWire(cx, cy, t);
+                            int low = horizontal ? graph.nodes.x_low[wire] : graph.nodes.y_low[wire];
+                            int high = horizontal ? graph.nodes.x_high[wire] : graph.nodes.y_high[wire];
+                            int dir = tracks_[t].direction;
+                            if (dir == 0 || (dir > 0 && low == pos) || (dir < 0 && high == pos)) {
+                                candidates.push_back(t);
+                            }
+                        }
+                        int nc = static_cast<int>(candidates.size());
+                        int n = std::min(n_out, nc);
+                        for (int k = 0; k < n; ++k) {
+                            int t = candidates[(pin_number + k * nc / n) % nc];
+                            int wire = horizontal ? chanxWire(cx, cy, t) : chanyWire(cx, cy, t);
+                            int sw = segment_switch_[tracks_[t].segment];
+                            edges.push_back({pin, wire, sw, wireEdgeDelay(arch, sw, t)});
+                        }
+                    } else {
+                        edges.push_back({pin, cls, -1, 0.0f});
+                        if (cx < 0) continue;
+
+                        // IPIN recebe n_in trilhas espalhadas pelo canal
+                        for (int k = 0; k < n_in; ++k) {
+                            int t = (pin_number + k * channel_width_ / n_in) % channel_width_;
+                            int wire = horizontal ? chanxWire(cx, cy, t) : chanyWire(cx, cy, t);
+                            edges.push_back({wire, pin, ipin_switch_, ipin_delay});
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void RoutingGraphBuilder::createSwitchConnections(
+    const FPGAArchitecture& arch,
+    const RoutingGraph& graph,
+    int y,
+    std::vector<RREdge>& edges
+) const {
+    if (y > grid_height_ - 2) return;
+
+    const int fs_per_side = std::max(1, arch.device.fs / 3);
+    const bool wilton = arch.device.switch_block_type == "wilton";
+    std::vector<int> incoming[4], outgoing[4];
+
+    // Switch block (x, y) fica no canto superior direito do tile (x, y)
+    for (int x = 0; x <= grid_width_ - 2; ++x) {
+        for (int s = 0; s < 4; ++s) {
+            incoming[s].clear();
+            outgoing[s].clear();
+        }
+
+        for (int t = 0; t < channel_width_; ++t) {
+            int dir = tracks_[t].direction;
+            int wire;
+
+            // LEFT: CHANX(x, y) terminando em x
+            if ((wire = chanxWire(x, y, t)) >= 0 && graph.nodes.x_high[wire] == x) {
+                if (dir >= 0) incoming[SIDE_LEFT].push_back(wire);
+                if (dir <= 0) outgoing[SIDE_LEFT].push_back(wire);
+            }
+            // RIGHT: CHANX(x+1, y) começando em x+1
+            if ((wire = chanxWire(x + 1, y, t)) >= 0 && graph.nodes.x_low[wire] == x + 1) {
+                if (dir <= 0) incoming[SIDE_RIGHT].push_back(wire);
+                if (dir >= 0) outgoing[SIDE_RIGHT].push_back(wire);
+            }
+            // BOTTOM: CHANY(x, y) terminando em y
+            if ((wire = chanyWire(x, y, t)) >= 0 && graph.nodes.y_high[wire] == y) {
+                if (dir >= 0) incoming[SIDE_BOTTOM].push_back(wire);
+                if (dir <= 0) outgoing[SIDE_BOTTOM].push_back(wire);
+            }
+            // TOP: CHANY(x, y+1) começando em y+1
+            if ((wire = chanyWire(x, y + 1, t)) >= 0 && graph.nodes.y_low[wire] == y + 1) {
+                if (dir <= 0) incoming[SIDE_TOP].push_back(wire);
+                if (dir >= 0) outgoing[SIDE_TOP].push_back(wire);
+            }
+        }
+
+        // Cada par de lados liga fs/3 fios por fio do lado mais cheio, de modo
+        // que todo fio que chega e todo fio que sai tenha ao menos uma conexão;
+        // no wilton as curvas são rotacionadas para espalhar as trilhas
+        for (int s_in = 0; s_in < 4; ++s_in) {
+            for (int s_out = 0; s_out < 4; ++s_out) {
+                if (s_out == s_in || incoming[s_in].empty() || outgoing[s_out].empty()) continue;
+                int n_in = static_cast<int>(incoming[s_in].size());
+                int n_out = static_cast<int>(outgoing[s_out].size());
+                int rot = 0;
+                if (wilton && (s_in + 2) % 4 != s_out) {
+                    rot = (s_in + 1) % 4 == s_out ? 1 : -1;
+                }
+
+                auto connect = [&](int from, int target) {
+                    int t = graph.nodes.ptc[target];
+                    int sw = segment_switch_[tracks_[t].segment];
+                    edges.push_back({from, target, sw, wireEdgeDelay(arch, sw, t)});
+                };
+
+                if (n_in >= n_out) {
+                    int per_side = std::min(fs_per_side, n_out);
+                    for (int i = 0; i < n_in; ++i) {
+                        for (int j = 0; j < per_side; ++j) {
+                            int k = ((i + rot + j * n_out / per_side) % n_out + n_out) % n_out;
+                            connect(incoming[s_in][i], outgoing[s_out][k]);
+                        }
+                    }
+                } else {
+                    int per_side = std::min(fs_per_side, n_in);
+                    for (int o = 0; o < n_out; ++o) {
+                        for (int j = 0; j < per_side; ++j) {
+                            int k = ((o - rot + j * n_in / per_side) % n_in + n_in) % n_in;
+                            connect(incoming[s_in][k], outgoing[s_out][o]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void RoutingGraphBuilder::createDirectConnections(
+    const FPGAArchitecture& arch,
+    std::vector<RREdge>& edges
+) const {
+    // "tile.porta" ou "tile.porta[a:b]" -> (tile, porta)
+    auto resolve = [&](const std::string& pin, int& tile, int& port) {
+        tile = port = -1;
+        size_t dot = pin.find('.');
+        if (dot == std::string::npos) return false;
+        std::string tile_name = pin.substr(0, dot);
+        std::string port_name = pin.substr(dot + 1, pin.find('[') == std::string::npos
+                                                    ? std::string::npos : pin.find('[') - dot - 1);
+        for (size_t t = 0; t < arch.tiles.size(); ++t) {
+            if (arch.tiles[t].name != tile_name) continue;
+            for (size_t p = 0; p < arch.tiles[t].ports.size(); ++p) {
+                if (arch.tiles[t].ports[p].name == port_name) {
+                    tile = static_cast<int>(t);
+                    port = static_cast<int>(p);
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    for (const auto& direct : arch.directs) {
+        int from_tile, from_port, to_tile, to_port;
+        if (!resolve(direct.from_pin, from_tile, from_port) || !resolve(direct.to_pin, to_tile, to_port)) {
+            continue;  // Directs internos do cluster não viram arestas do RR graph
+        }
+        int num_pins = std::min(arch.tiles[from_tile].ports[from_port].num_pins,
+                                arch.tiles[to_tile].ports[to_port].num_pins);
+
+        for (int y = 0; y < grid_height_; ++y) {
+            for (int x = 0; x < grid_width_; ++x) {
+                const GridCell& from = grid_[y * grid_width_ + x];
+                if (from.tile != from_tile || from.y_offset != 0) continue;
+                int tx = x + direct.x_offset;
+                int ty = y + direct.y_offset;
+                if (tx < 0 || tx >= grid_width_ || ty < 0 || ty >= grid_height_) continue;
+                const GridCell& to = grid_[ty * grid_width_ + tx];
+                if (to.tile != to_tile || to.y_offset != 0) continue;
+
+                for (int z = 0; z < std::max(1, arch.tiles[from_tile].capacity); ++z) {
+                    int tz = z + direct.z_offset;
+                    if (tz < 0 || tz >= std::max(1, arch.tiles[to_tile].capacity)) continue;
+                    for (int i = 0; i < num_pins; ++i) {
+                        edges.push_back({pinNode(x, y, z, from_port, i), pinNode(tx, ty, tz, to_port, i), -1, 0.0f});
+                    }
+                }
+            }
+        }
+    }
+}
+
+TerminalMap RoutingGraphBuilder::mapTerminals(
+    const PackedNetlist& netlist,
+    const std::vector<Placement>& placements,
+    const FPGAArchitecture& arch
+) const {
+    // 1. Bloco de cada placement: pelo índice "#N" quando ele confere com o
+    //    nome; senão pelo nome (tabela montada só se for preciso)
+    const size_t num_blocks = netlist.blocks.size();
+    std::vector<int> block_tile(num_blocks, -1);
+    std::vector<int> block_base(num_blocks, -1);
+    std::unordered_map<std::string, int> block_by_name;
+    for (const auto& placement : placements) {
+        int block = placement.block_num;
+        if (block < 0 || block >= static_cast<int>(num_blocks) ||
+            netlist.blocks[block].name != placement.block_name) {
+            if (block_by_name.empty()) {
+                for (size_t b = 0; b < num_blocks; ++b) {
+                    block_by_name.emplace(netlist.blocks[b].name, static_cast<int>(b));
+                }
+            }
+            auto it = block_by_name.find(placement.block_name);
+            if (it == block_by_name.end()) continue;
+            block = it->second;
+        }
+
+        int x, y, z;
+        if (!locateBlock(arch, placement, x, y, z)) continue;
+        int tile = grid_[y * grid_width_ + x].tile;
+        block_tile[block] = tile;
+        block_base[block] = tile_base_[y * grid_width_ + x] + z * templates_[tile].nodes_per_instance;
+    }
+
+    // 2. Porta do tile para cada (tipo de tile, porta do netlist); -1 se não existir
+    const size_t num_ports = netlist.port_names.size();
+    std::vector<int> tile_port(arch.tiles.size() * num_ports, -1);
+    for (size_t t = 0; t < arch.tiles.size(); ++t) {
+        for (size_t port = 0; port < num_ports; ++port) {
+            const auto& ports = arch.tiles[t].ports;
+            for (size_t p = 0; p < ports.size(); ++p) {
+                if (ports[p].name == netlist.port_names[port]) {
+                    tile_port[t * num_ports + port] = static_cast<int>(p);
+                }
+            }
+        }
+    }
+
+    // 3. Terminais: só aritmética sobre índices densos
+    TerminalMap map;
+    map.net_begin.reserve(netlist.nets.size() + 1);
+    map.net_begin.push_back(0);
+    for (const auto& net : netlist.nets) {
+        map.net_begin.push_back(map.net_begin.back() + 1 + static_cast<int>(net.sinks.size()));
+    }
+    map.class_node.assign(map.net_begin.back(), -1);
+    map.pin_node.assign(map.net_begin.back(), -1);
+
+    auto place = [&](const NetPin& terminal, int slot) {
+        if (terminal.block < 0 || block_base[terminal.block] < 0) return;
+        int tile = block_tile[terminal.block];
+        int port = tile_port[tile * num_ports + terminal.port];
+        if (port < 0) return;
+        const Port& tile_port_def = arch.tiles[tile].ports[port];
+        if (terminal.pin >= tile_port_def.num_pins) return;
+
+        const TileTemplate& tmpl = templates_[tile];
+        int base = block_base[terminal.block];
+        map.pin_node[slot] = base + tmpl.port_pin_offset[port] + terminal.pin;
+        map.class_node[slot] = base + tmpl.port_class_offset[port]
+                             + (tile_port_def.equivalent ? 0 : terminal.pin);
+    };
+    for (size_t n = 0; n < netlist.nets.size(); ++n) {
+        const PackedNet& net = netlist.nets[n];
+        int slot = map.net_begin[n];
+        place(net.driver, slot++);
+        for (const NetPin& terminal : net.sinks) place(terminal, slot++);
+    }
+    return map;
 }
 
 void RoutingGraphBuilder::mapNetsToPhysicalNodes(
-    const std::vector<Net>& logical_nets,
+    const PackedNetlist& netlist,
     const std::vector<Placement>& placements,
     const FPGAArchitecture& arch,
     std::vector<Net>& physical_nets,
     RoutingGraph& graph
 ) {
-    // Mapeamento simplificado: atribuir nós fictícios
-    for (size_t i = 0; i < logical_nets.size(); ++i) {
-        Net physical_net = logical_nets[i];
-        
-        // Driver no primeiro nó, sinks distribuídos
-        if (graph.nodes.size() > 0) {
-            physical_net.driver = 0;  // Driver no nó 0
-            
-            // Sinks em outros nós
-            physical_net.sinks.clear();
-            for (size_t j = 1; j < std::min((size_t)3, graph.nodes.size()); ++j) {
-                physical_net.sinks.push_back(j);
-            }
-        }
-        
-        physical_nets.push_back(physical_net);
-    }
-}
\ No newline at end of file
+    TerminalMap terminals = mapTerminals(netlist, placements, arch);
+
+    // Última net que incluiu cada SINK (une sinks de pinos equivalentes)
+    std::vector<int> sink_owner(graph.nodes.size(), -1);
+
+    physical_nets.reserve(physical_nets.size() + netlist.nets.size());
+    for (size_t n = 0; n < netlist.nets.size(); ++n) {
+        Net physical_net;
+        physical_net.id = static_cast<int>(n);
+        physical_net.name = netlist.nets[n].name;
+        physical_net.driver = terminals.class_node[terminals.net_begin[n]];
+        physical_net.driver_block = netlist.nets[n].driver.block;
+
+        for (int t = terminals.net_begin[n] + 1; t < terminals.net_begin[n + 1]; ++t) {
+            int sink = terminals.class_node[t];
+            if (sink < 0 || sink_owner[sink] == static_cast<int>(n)) continue;
+            sink_owner[sink] = static_cast<int>(n);
+            physical_net.sinks.push_back(sink);
+            physical_net.sink_blocks.push_back(netlist.nets[n].sinks[t - terminals.net_begin[n] - 1].block);
+        }
+        physical_nets.push_back(std::move(physical_net));
+    }
+}
@@ -0,0 +1,265 @@
+#include "routing/graph_cache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'R', 'R', 'G', 'R', 'A', 'P', 'H', '\0'};
+const uint32_t CACHE_ENDIAN = 0x01020304;
+
+// Cabeçalho do arquivo; todas as seções começam em múltiplos de 8 bytes
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint64_t arch_hash;
+    int32_t grid_width, grid_height, channel_width, reserved;
+    uint64_t num_nodes, num_edges, num_switches, num_names, name_bytes, num_rc;
+    uint64_t file_size;
+};
+
+// Seções na ordem do arquivo
+enum CacheSection {
+    SEC_TYPES, SEC_X_LOW, SEC_Y_LOW, SEC_X_HIGH, SEC_Y_HIGH, SEC_PTC, SEC_CAPACITY,
+    SEC_BASE_COST, SEC_DELAY, SEC_NAME_ID, SEC_NAME_OFFSETS, SEC_NAME_CHARS,
+    SEC_RC_INDEX, SEC_RC_DATA,
+    SEC_OUT_OFFSETS, SEC_OUT_EDGES, SEC_IN_OFFSETS, SEC_IN_EDGES, SEC_SWITCHES,
+    NUM_SECTIONS
+};
+
+// Tabela de seções logo após o cabeçalho: início e tamanho em bytes
+struct SectionEntry {
+    uint64_t offset, bytes;
+};
+
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+} // namespace
+
+std::string graph_cache_path(const std::string& dir, const GraphCacheKey& key) {
+    std::ostringstream name;
+    name << dir << "/rrgraph_" << std::hex << std::setw(16) << std::setfill('0') << key.arch_hash
+         << std::dec << "_" << key.grid_width << "x" << key.grid_height
+         << "_w" << key.channel_width << ".bin";
+    return name.str();
+}
+
+bool save_graph_cache(const std::string& filename, const RoutingGraph& graph,
+                      const GraphCacheKey& key) {
+    if (!graph.isFrozen()) return false;
+
+    // Tabela de nomes: deslocamento de cada nome em name_chars
+    const RRNodeStore& nodes = graph.nodes;
+    std::vector<uint32_t> name_offsets(1, 0);
+    std::string name_chars;
+    for (const auto& name : nodes.names) {
+        name_chars += name;
+        name_offsets.push_back(static_cast<uint32_t>(name_chars.size()));
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = GRAPH_CACHE_VERSION;
+    header.endian = CACHE_ENDIAN;
+    header.arch_hash = key.arch_hash;
+    header.grid_width = key.grid_width;
+    header.grid_height = key.grid_height;
+    header.channel_width = key.channel_width;
+    header.num_nodes = nodes.size();
+    header.num_edges = graph.out_edges.size();
+    header.num_switches = graph.switches.size();
+    header.num_names = nodes.names.size();
+    header.name_bytes = name_chars.size();
+    header.num_rc = nodes.rc_data.size();
+
+    const void* data[NUM_SECTIONS] = {
+        nodes.types.data(), nodes.x_low.data(), nodes.y_low.data(), nodes.x_high.data(),
+        nodes.y_high.data(), nodes.ptc.data(), nodes.capacity.data(), nodes.base_cost.data(),
+        nodes.delay.data(), nodes.name_id.data(), name_offsets.data(), name_chars.data(),
+        nodes.rc_index.data(), nodes.rc_data.data(),
+        graph.out_offsets.data(), graph.out_edges.data(), graph.in_offsets.data(),
+        graph.in_edges.data(), graph.switches.data()
+    };
+    SectionEntry sections[NUM_SECTIONS] = {
+        {0, nodes.types.size() * sizeof(uint8_t)},
+        {0, nodes.x_low.size() * sizeof(int16_t)},
+        {0, nodes.y_low.size() * sizeof(int16_t)},
+        {0, nodes.x_high.size() * sizeof(int16_t)},
+        {0, nodes.y_high.size() * sizeof(int16_t)},
+        {0, nodes.ptc.size() * sizeof(int16_t)},
+        {0, nodes.capacity.size() * sizeof(uint16_t)},
+        {0, nodes.base_cost.size() * sizeof(float)},
+        {0, nodes.delay.size() * sizeof(float)},
+        {0, nodes.name_id.size() * sizeof(uint16_t)},
+        {0, name_offsets.size() * sizeof(uint32_t)},
+        {0, name_chars.size()},
+        {0, nodes.rc_index.size() * sizeof(uint16_t)},
+        {0, nodes.rc_data.size() * sizeof(RRNodeRC)},
+        {0, graph.out_offsets.size() * sizeof(int)},
+        {0, graph.out_edges.size() * sizeof(RRAdjEdge)},
+        {0, graph.in_offsets.size() * sizeof(int)},
+        {0, graph.in_edges.size() * sizeof(RRAdjEdge)},
+        {0, graph.switches.size() * sizeof(RRSwitch)}
+    };
+    uint64_t offset = align8(sizeof(CacheHeader) + sizeof(sections));
+    for (auto& section : sections) {
+        section.offset = offset;
+        offset = align8(offset + section.bytes);
+    }
+    header.file_size = offset;
+
+    // Temporário único por processo e thread: duas execuções gravando a
+    // mesma chave não sobrescrevem o temporário uma da outra
+    std::ostringstream tmp;
+    tmp << filename << ".tmp." << getpid() << "."
+        << std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::string tmp_name = tmp.str();
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    uint64_t written = 0;
+    auto writeAt = [&](uint64_t at, const void* bytes, size_t count) {
+        static const char zeros[8] = {0};
+        out.write(zeros, static_cast<std::streamsize>(at - written));
+        out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+        written = at + count;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(sizeof(header), sections, sizeof(sections));
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        writeAt(sections[i].offset, data[i], sections[i].bytes);
+    }
+    writeAt(header.file_size, nullptr, 0);
+    out.close();
+
+    if (!out || std::rename(tmp_name.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_name.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool load_graph_cache(const std::string& filename, const GraphCacheKey& key,
+                      RoutingGraph& graph) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CacheHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    // Cópia privada: páginas só são copiadas se alguém escrever nelas
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return false;
+    std::shared_ptr<void> mapping(addr, [size](void* p) { munmap(p, size); });
+
+    char* base = static_cast<char*>(addr);
+    const CacheHeader& header = *reinterpret_cast<const CacheHeader*>(base);
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != GRAPH_CACHE_VERSION || header.endian != CACHE_ENDIAN ||
+        header.file_size != size || header.arch_hash != key.arch_hash ||
+        header.grid_width != key.grid_width || header.grid_height != key.grid_height ||
+        header.channel_width != key.channel_width) {
+        return false;
+    }
+
+    // Seções com o tamanho esperado e dentro do arquivo (truncado ou corrompido)
+    if (size < sizeof(CacheHeader) + sizeof(SectionEntry) * NUM_SECTIONS) return false;
+    const SectionEntry* sections = reinterpret_cast<const SectionEntry*>(base + sizeof(CacheHeader));
+    const uint64_t n = header.num_nodes, e = header.num_edges;
+    const uint64_t expected[NUM_SECTIONS] = {
+        n * sizeof(uint8_t), n * sizeof(int16_t), n * sizeof(int16_t), n * sizeof(int16_t),
+        n * sizeof(int16_t), n * sizeof(int16_t), n * sizeof(uint16_t), n * sizeof(float),
+        n * sizeof(float), n * sizeof(uint16_t), (header.num_names + 1) * sizeof(uint32_t),
+        header.name_bytes, n * sizeof(uint16_t), header.num_rc * sizeof(RRNodeRC), (n + 1) * sizeof(int), e * sizeof(RRAdjEdge), (n + 1) * sizeof(int),
+        e * sizeof(RRAdjEdge), header.num_switches * sizeof(RRSwitch)
+    };
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        if (sections[i].bytes != expected[i] || sections[i].offset % 8 != 0 ||
+            sections[i].offset > size || sections[i].bytes > size - sections[i].offset) {
+            return false;
+        }
+    }
+    auto at = [&](CacheSection section) { return base + sections[section].offset; };
+
+    const uint32_t* name_offsets = reinterpret_cast<const uint32_t*>(at(SEC_NAME_OFFSETS));
+    const char* name_chars = at(SEC_NAME_CHARS);
+    std::vector<std::string> names(header.num_names);
+    for (uint64_t i = 0; i < header.num_names; ++i) {
+        if (name_offsets[i] > name_offsets[i + 1] || name_offsets[i + 1] > header.name_bytes) return false;
+        names[i].assign(name_chars + name_offsets[i], name_offsets[i + 1] - name_offsets[i]);
+    }
+    const uint16_t* name_id = reinterpret_cast<const uint16_t*>(at(SEC_NAME_ID));
+    for (uint64_t i = 0; i < n; ++i) {
+        if (name_id[i] >= header.num_names) return false;
+    }
+    const uint16_t* rc_index = reinterpret_cast<const uint16_t*>(at(SEC_RC_INDEX));
+    for (uint64_t i = 0; i < n; ++i) {
+        if (rc_index[i] >= header.num_rc) return false;
+    }
+    const RRNodeRC* rc_data = reinterpret_cast<const RRNodeRC*>(at(SEC_RC_DATA));
+
+    // CSR: deslocamentos monótonos de 0 a e, e arestas com nó e switch válidos
+    auto validAdjacency = [&](CacheSection offsets_section, CacheSection edges_section) {
+        const int* offsets = reinterpret_cast<const int*>(at(offsets_section));
+        const RRAdjEdge* edges = reinterpret_cast<const RRAdjEdge*>(at(edges_section));
+        if (offsets[0] != 0 || static_cast<uint64_t>(offsets[n]) != e) return false;
+        for (uint64_t i = 0; i < n; ++i) {
+            if (offsets[i] > offsets[i + 1]) return false;
+        }
+        for (uint64_t i = 0; i < e; ++i) {
+            if (edges[i].node < 0 || static_cast<uint64_t>(edges[i].node) >= n ||
+                edges[i].rr_switch < 0 ||
+                static_cast<uint64_t>(edges[i].rr_switch) >= header.num_switches) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!validAdjacency(SEC_OUT_OFFSETS, SEC_OUT_EDGES) ||
+        !validAdjacency(SEC_IN_OFFSETS, SEC_IN_EDGES)) {
+        return false;
+    }
+
+    RRNodeStore nodes;
+    nodes.types.setView(reinterpret_cast<uint8_t*>(at(SEC_TYPES)), n);
+    nodes.x_low.setView(reinterpret_cast<int16_t*>(at(SEC_X_LOW)), n);
+    nodes.y_low.setView(reinterpret_cast<int16_t*>(at(SEC_Y_LOW)), n);
+    nodes.x_high.setView(reinterpret_cast<int16_t*>(at(SEC_X_HIGH)), n);
+    nodes.y_high.setView(reinterpret_cast<int16_t*>(at(SEC_Y_HIGH)), n);
+    nodes.ptc.setView(reinterpret_cast<int16_t*>(at(SEC_PTC)), n);
+    nodes.capacity.setView(reinterpret_cast<uint16_t*>(at(SEC_CAPACITY)), n);
+    nodes.base_cost.setView(reinterpret_cast<float*>(at(SEC_BASE_COST)), n);
+    nodes.delay.setView(reinterpret_cast<float*>(at(SEC_DELAY)), n);
+    nodes.name_id.setView(reinterpret_cast<uint16_t*>(at(SEC_NAME_ID)), n);
+    nodes.rc_index.setView(reinterpret_cast<uint16_t*>(at(SEC_RC_INDEX)), n);
+    nodes.rc_data.assign(rc_data, rc_data + header.num_rc);
+    nodes.names.swap(names);
+
+    graph.nodes = std::move(nodes);
+    graph.edges.clear();
+    graph.out_offsets.setView(reinterpret_cast<int*>(at(SEC_OUT_OFFSETS)), n + 1);
+    graph.out_edges.setView(reinterpret_cast<RRAdjEdge*>(at(SEC_OUT_EDGES)), e);
+    graph.in_offsets.setView(reinterpret_cast<int*>(at(SEC_IN_OFFSETS)), n + 1);
+    graph.in_edges.setView(reinterpret_cast<RRAdjEdge*>(at(SEC_IN_EDGES)), e);
+    graph.switches.setView(reinterpret_cast<RRSwitch*>(at(SEC_SWITCHES)), header.num_switches);
+    graph.occupancy.init(graph.nodes);
+    graph.storage = mapping;
+    return true;
+}
@@ -0,0 +1,121 @@
+#include "routing/lookahead.h"
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+
+static const int kNumNodeTypes = static_cast<int>(RRNodeType::EDGE) + 1;
+static const float kUnset = std::numeric_limits<float>::infinity();
+
+void RouterLookahead::build(const RoutingGraph& graph, int samples_per_type) {
+    table_.clear();
+    if (graph.nodes.empty()) return;
+    
+    int max_x = 0, max_y = 0;
+    const RRNodeStore& nodes = graph.nodes;
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        max_x = std::max<int>(max_x, nodes.x_high[id]);
+        max_y = std::max<int>(max_y, nodes.y_high[id]);
+    }
+    max_dx_ = max_x;
+    max_dy_ = max_y;
+    table_.assign(kNumNodeTypes * (max_dx_ + 1) * (max_dy_ + 1), {kUnset, kUnset});
+    
+    // Agrupar nós por tipo
+    std::vector<std::vector<int>> by_type(kNumNodeTypes);
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        by_type[nodes.types[id]].push_back(static_cast<int>(id));
+    }
+    
+    // Âncoras de amostragem: centro e cantos opostos, para cobrir
+    // deslocamentos de até o tamanho total do dispositivo
+    const int anchors[][2] = {
+        {max_x / 2, max_y / 2}, {1, 1}, {max_x - 1, max_y - 1},
+        {1, max_y - 1}, {max_x - 1, 1}
+    };
+    const int num_anchors = sizeof(anchors) / sizeof(anchors[0]);
+    
+    for (int type = 0; type < kNumNodeTypes; ++type) {
+        const auto& candidates = by_type[type];
+        if (candidates.empty()) continue;
+        
+        std::vector<int> samples;
+        for (int i = 0; i < samples_per_type; ++i) {
+            int ax = anchors[i % num_anchors][0], ay = anchors[i % num_anchors][1];
+            int best = -1, best_dist = std::numeric_limits<int>::max();
+            for (int id : candidates) {
+                int d = std::abs(nodes.x_low[id] - ax) + std::abs(nodes.y_low[id] - ay);
+                if (d < best_dist && std::find(samples.begin(), samples.end(), id) == samples.end()) {
+                    best = id;
+                    best_dist = d;
+                }
+            }
+            if (best < 0) break;
+            samples.push_back(best);
+        }
+        
+        for (int source_id : samples) {
+            sampleFrom(graph, source_id);
+        }
+        
+        // Preencher deslocamentos não observados a partir dos vizinhos menores
+        for (int dy = 0; dy <= max_dy_; ++dy) {
+            for (int dx = 0; dx <= max_dx_; ++dx) {
+                Entry& entry = table_[index(type, dx, dy)];
+                if (entry.cong != kUnset) continue;
+                
+                Entry fill = {0.0f, 0.0f};
+                if (dx > 0) fill = table_[index(type, dx - 1, dy)];
+                if (dy > 0) {
+                    const Entry& below = table_[index(type, dx, dy - 1)];
+                    fill.delay = std::max(fill.delay, below.delay);
+                    fill.cong = std::max(fill.cong, below.cong);
+                }
+                entry = fill;
+            }
+        }
+    }
+}
+
+void RouterLookahead::sampleFrom(const RoutingGraph& graph, int source_id) {
+    struct Item {
+        int id;
+        float cong;
+        bool operator>(const Item& other) const { return cong > other.cong; }
+    };
+    
+    // Dijkstra sem congestionamento sobre o custo base, acumulando o atraso do caminho
+    std::vector<float> cong(graph.nodes.size(), kUnset);
+    std::vector<float> delay(graph.nodes.size(), 0.0f);
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    
+    const RRNodeStore& nodes = graph.nodes;
+    int type = nodes.types[source_id];
+    int source_x_low = nodes.x_low[source_id], source_x_high = nodes.x_high[source_id];
+    int source_y_low = nodes.y_low[source_id], source_y_high = nodes.y_high[source_id];
+    cong[source_id] = 0.0f;
+    pq.push({source_id, 0.0f});
+    
+    while (!pq.empty()) {
+        Item current = pq.top();
+        pq.pop();
+        if (current.cong > cong[current.id]) continue;
+        
+        // Registrar o custo para o deslocamento deste nó em relação à fonte
+        int dx = std::min(distance(nodes.x_low[current.id], source_x_low, source_x_high), max_dx_);
+        int dy = std::min(distance(nodes.y_low[current.id], source_y_low, source_y_high), max_dy_);
+        Entry& entry = table_[index(type, dx, dy)];
+        entry.delay = std::min(entry.delay, delay[current.id]);
+        entry.cong = std::min(entry.cong, current.cong);
+        
+        for (auto edge : graph.outEdges(current.id)) {
+            float base_cost = nodes.base_cost[edge.node] > 0 ? nodes.base_cost[edge.node] : 1.0f;
+            float new_cong = current.cong + base_cost;
+            if (new_cong < cong[edge.node]) {
+                cong[edge.node] = new_cong;
+                delay[edge.node] = delay[current.id] + nodes.delay[edge.node] + edge.delay;
+                pq.push({edge.node, new_cong});
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include "routing/occupancy.h"
+#include "routing/types.h"
+
+RROccupancy& RROccupancy::operator=(RROccupancy&& other) noexcept {
+    words_ = std::move(other.words_);
+    capacity_ = std::move(other.capacity_);
+    listed_ = std::move(other.listed_);
+    num_listed_.store(other.num_listed_.load());
+    total_overuse_.store(other.total_overuse_.load());
+    num_overused_.store(other.num_overused_.load());
+    size_ = other.size_;
+    epoch_ = other.epoch_;
+    other.size_ = 0;
+    return *this;
+}
+
+void RROccupancy::init(const RRNodeStore& nodes) {
+    size_ = nodes.size();
+    words_.reset(new std::atomic<uint64_t>[size_]);
+    for (size_t id = 0; id < size_; ++id) words_[id].store(0, std::memory_order_relaxed);
+    capacity_.assign(nodes.capacity.begin(), nodes.capacity.end());
+    listed_.reset(new int[size_]);
+    epoch_ = 1;
+    num_listed_ = 0;
+    total_overuse_ = 0;
+    num_overused_ = 0;
+}
+
+void RROccupancy::reset() {
+    if (++epoch_ > MAX_EPOCH) {
+        for (size_t id = 0; id < size_; ++id) words_[id].store(0, std::memory_order_relaxed);
+        epoch_ = 1;
+    }
+    num_listed_ = 0;
+    total_overuse_ = 0;
+    num_overused_ = 0;
+}
+
+void RROccupancy::add(int id, int delta) {
+    std::atomic<uint64_t>& slot = words_[id];
+    int cap = capacity_[id];
+    uint64_t old_word = slot.load(std::memory_order_relaxed);
+    uint64_t new_word;
+    int old_count, new_count;
+    bool list_now;
+    do {
+        // Palavra de outra época conta como zero
+        bool current = (old_word >> EPOCH_SHIFT) == epoch_;
+        old_count = current ? static_cast<int>(static_cast<uint32_t>(old_word)) : 0;
+        bool listed = current && (old_word & LISTED_BIT);
+        new_count = old_count + delta;
+        list_now = !listed && new_count > cap;
+        new_word = (static_cast<uint64_t>(epoch_) << EPOCH_SHIFT) |
+                   (listed || list_now ? LISTED_BIT : 0) | static_cast<uint32_t>(new_count);
+    } while (!slot.compare_exchange_weak(old_word, new_word, std::memory_order_relaxed));
+
+    int old_over = std::max(0, old_count - cap), new_over = std::max(0, new_count - cap);
+    if (new_over != old_over) {
+        total_overuse_.fetch_add(new_over - old_over, std::memory_order_relaxed);
+        if (old_over == 0) num_overused_.fetch_add(1, std::memory_order_relaxed);
+        if (new_over == 0) num_overused_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (list_now) listed_[num_listed_.fetch_add(1, std::memory_order_relaxed)] = id;
+}
+
+void RROccupancy::commit(const RouteTree& tree) {
+    for (const auto& tree_node : tree.nodes) add(tree_node.rr_node, 1);
+}
+
+void RROccupancy::ripUp(const RouteTree& tree) {
+    for (const auto& tree_node : tree.nodes) add(tree_node.rr_node, -1);
+}
+
+OveruseSummary RROccupancy::summary() {
+    OveruseSummary result;
+    result.total_overuse = totalOveruse();
+
+    // Nós que voltaram à capacidade saem da lista e podem entrar de novo
+    size_t kept = 0;
+    size_t num_listed = num_listed_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < num_listed; ++i) {
+        int id = listed_[i];
+        int over = overuse(id);
+        if (over > 0) {
+            listed_[kept++] = id;
+            result.max_overuse = std::max(result.max_overuse, over);
+        } else {
+            words_[id].fetch_and(~LISTED_BIT, std::memory_order_relaxed);
+        }
+    }
+    num_listed_ = kept;
+
+    result.nodes.assign(listed_.get(), listed_.get() + kept);
+    std::sort(result.nodes.begin(), result.nodes.end());
+    return result;
+}
@@ -0,0 +1,58 @@
+#include "routing/partition.h"
+
+void NetPartitioner::build(const BoundingBox& device, int max_level) {
+    regions_.clear();
+    levels_.clear();
+    split(device, 0, max_level);
+}
+
+int NetPartitioner::split(const BoundingBox& box, int level, int max_level) {
+    int index = static_cast<int>(regions_.size());
+    regions_.push_back({box, level, {-1, -1}, {}});
+    if (static_cast<int>(levels_.size()) <= level) levels_.resize(level + 1);
+    levels_[level].push_back(index);
+    
+    int width = box.x_max - box.x_min + 1;
+    int height = box.y_max - box.y_min + 1;
+    if (level >= max_level || (width < 2 && height < 2)) return index;
+    
+    // Cortar o lado mais longo ao meio; as metades não se sobrepõem
+    BoundingBox low = box, high = box;
+    if (width >= height) {
+        int mid = box.x_min + width / 2 - 1;
+        low.x_max = mid;
+        high.x_min = mid + 1;
+    } else {
+        int mid = box.y_min + height / 2 - 1;
+        low.y_max = mid;
+        high.y_min = mid + 1;
+    }
+    
+    int child_low = split(low, level + 1, max_level);
+    int child_high = split(high, level + 1, max_level);
+    regions_[index].children[0] = child_low;
+    regions_[index].children[1] = child_high;
+    return index;
+}
+
+void NetPartitioner::assign(const std::vector<BoundingBox>& net_boxes) {
+    for (auto& region : regions_) {
+        region.nets.clear();
+    }
+    
+    for (size_t i = 0; i < net_boxes.size(); ++i) {
+        int current = 0;
+        while (true) {
+            const PartitionRegion& region = regions_[current];
+            int next = -1;
+            for (int child : region.children) {
+                if (child >= 0 && regions_[child].box.contains(net_boxes[i])) {
+                    next = child;
+                }
+            }
+            if (next < 0) break;
+            current = next;
+        }
+        regions_[current].nets.push_back(static_cast<int>(i));
+    }
+}
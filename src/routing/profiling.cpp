@@ -0,0 +1,75 @@
+#include "routing/profiling.h"
+#include "routing/router.h"
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+// String JSON com aspas, barras e controles escapados
+std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+bool write_profile_report(
+    const std::string& filename,
+    const Profiler& profiler,
+    const Router& router,
+    const std::vector<Net>& nets
+) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out) return false;
+
+    out << "{\n  \"profiling\": " << (ROUTER_PROFILING ? "true" : "false") << ",\n";
+
+    out << "  \"phases\": [";
+    const auto& phases = profiler.phases();
+    for (size_t i = 0; i < phases.size(); ++i) {
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << json_string(phases[i].name)
+            << ", \"ms\": " << phases[i].ms << "}";
+    }
+    out << "\n  ],\n";
+
+    const RouterStats& stats = router.stats();
+    out << "  \"router\": {\n"
+        << "    \"iterations\": " << router.iterations() << ",\n"
+        << "    \"legal\": " << (router.isLegal() ? "true" : "false") << ",\n"
+        << "    \"connections\": " << stats.connections << ",\n"
+        << "    \"bidirectional\": " << stats.bidirectional << ",\n"
+        << "    \"heap_pushes\": " << stats.heap_pushes << ",\n"
+        << "    \"heap_pops\": " << stats.heap_pops << ",\n"
+        << "    \"nodes_expanded\": " << stats.nodes_expanded << ",\n"
+        << "    \"stale_pops\": " << stats.stale_pops << ",\n"
+        << "    \"reexpansions\": " << stats.reexpansions << ",\n"
+        << "    \"edges_relaxed\": " << stats.edges_relaxed << "\n"
+        << "  },\n";
+
+    // Tempo por net, na ordem do roteamento
+    out << "  \"nets\": [";
+    const auto& net_ms = router.netTimes();
+    for (size_t i = 0; i < nets.size() && i < net_ms.size(); ++i) {
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << json_string(nets[i].name)
+            << ", \"ms\": " << net_ms[i] << "}";
+    }
+    out << "\n  ]\n}\n";
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,410 @@
+#include "routing/route_file.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+
+const char ROUTE_MAGIC[8] = {'R', 'R', 'R', 'O', 'U', 'T', 'E', '\0'};
+const uint32_t ROUTE_VERSION = 1;
+
+const char* node_type_name(RRNodeType type) {
+    switch (type) {
+        case RRNodeType::SOURCE: return "SOURCE";
+        case RRNodeType::SINK: return "SINK";
+        case RRNodeType::OPIN: return "OPIN";
+        case RRNodeType::IPIN: return "IPIN";
+        case RRNodeType::CHANX: return "CHANX";
+        case RRNodeType::CHANY: return "CHANY";
+        default: return "OTHER";
+    }
+}
+
+const char* ptc_label(RRNodeType type) {
+    switch (type) {
+        case RRNodeType::SOURCE:
+        case RRNodeType::SINK: return "Class";
+        case RRNodeType::OPIN:
+        case RRNodeType::IPIN: return "Pin";
+        default: return "Track";
+    }
+}
+
+// Saída em blocos: formata no buffer e grava quando ele enche
+class OutputBuffer {
+public:
+    explicit OutputBuffer(FILE* file) : file_(file) { data_.reserve(CAPACITY + 256); }
+
+    void put(const char* text) { data_.append(text); }
+    void put(const std::string& text) { data_.append(text); }
+    void put(char c) { data_.push_back(c); }
+    void putInt(long long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        data_.append(digits, result.ptr);
+    }
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        data_.push_back(static_cast<char>(value));
+    }
+    void putRaw(const void* bytes, size_t count) {
+        data_.append(static_cast<const char*>(bytes), count);
+    }
+
+    // Grava se o buffer passou da capacidade (chamar entre registros)
+    void maybeFlush() {
+        if (data_.size() >= CAPACITY) flush();
+    }
+    void flush() {
+        if (!data_.empty() && std::fwrite(data_.data(), 1, data_.size(), file_) != data_.size()) {
+            failed_ = true;
+        }
+        data_.clear();
+    }
+    bool failed() const { return failed_; }
+
+private:
+    static const size_t CAPACITY = 1 << 20;
+    FILE* file_;
+    std::string data_;
+    bool failed_ = false;
+};
+
+bool read_whole_file(const std::string& filename, std::string& contents) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    contents.resize(static_cast<size_t>(size));
+    return static_cast<bool>(file.read(&contents[0], size));
+}
+
+// Índice de cada net das rotas: pela posição se o nome bate, senão pelo nome
+class NetMatcher {
+public:
+    explicit NetMatcher(const std::vector<Net>& nets) : nets_(nets) {}
+
+    int find(long long index, const char* name, size_t length) {
+        if (index >= 0 && index < static_cast<long long>(nets_.size()) &&
+            nets_[index].name.compare(0, std::string::npos, name, length) == 0) {
+            return static_cast<int>(index);
+        }
+        if (by_name_.empty()) {
+            for (size_t i = 0; i < nets_.size(); ++i) by_name_.emplace(nets_[i].name, static_cast<int>(i));
+        }
+        auto it = by_name_.find(std::string(name, length));
+        return it == by_name_.end() ? -1 : it->second;
+    }
+
+private:
+    const std::vector<Net>& nets_;
+    std::unordered_map<std::string, int> by_name_;
+};
+
+// Completa uma árvore lida (só nós e pais): switches e atrasos pelas arestas
+// do grafo, como em Router::routeNet, e ramo de cada sink da net.
+// tree_index (por nó RR, -1 fora da árvore) é limpo na saída
+bool finish_tree(const RoutingGraph& graph, const Net& net, RouteTree& tree, std::vector<int>& tree_index) {
+    bool valid = tree.nodes.empty() || tree.nodes[0].rr_node == net.driver;
+    for (size_t i = 0; i < tree.nodes.size() && valid; ++i) {
+        RouteTreeNode& node = tree.nodes[i];
+        if (node.parent < 0) {
+            node.delay = graph.nodes.delay[node.rr_node];
+            node.switch_id = -1;
+            continue;
+        }
+        int edge_id = graph.findEdge(tree.nodes[node.parent].rr_node, node.rr_node);
+        if (edge_id < 0) {
+            valid = false;
+            break;
+        }
+        RREdgeView edge = graph.edge(edge_id);
+        node.delay = tree.nodes[node.parent].delay + edge.delay + graph.nodes.delay[node.rr_node];
+        node.switch_id = edge.switch_id;
+    }
+
+    tree.total_delay = 0.0f;
+    tree.routed = valid && !tree.nodes.empty();
+    tree.sink_branches.assign(net.sinks.size(), -1);
+    if (valid) {
+        for (size_t k = 0; k < net.sinks.size(); ++k) {
+            int branch = tree_index[net.sinks[k]];
+            tree.sink_branches[k] = branch;
+            if (branch < 0) {
+                tree.routed = false;
+            } else {
+                tree.total_delay = std::max(tree.total_delay, tree.nodes[branch].delay);
+            }
+        }
+    }
+
+    for (const auto& node : tree.nodes) tree_index[node.rr_node] = -1;
+    return valid;
+}
+
+bool valid_node(const RoutingGraph& graph, long long id) {
+    return id >= 0 && id < static_cast<long long>(graph.nodes.size());
+}
+
+} // namespace
+
+bool write_route_file(
+    const std::string& filename,
+    const RoutingGraph& graph,
+    const std::vector<Net>& nets,
+    const std::vector<RouteTree>& routes,
+    const RouteFileInfo& info
+) {
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) return false;
+
+    const RRNodeStore& nodes = graph.nodes;
+    OutputBuffer out(file);
+    out.put("Placement_File: ");
+    out.put(info.placement_file);
+    if (!info.placement_id.empty()) {
+        out.put(" Placement_ID: ");
+        out.put(info.placement_id);
+    }
+    out.put("\nArray size: ");
+    out.putInt(info.grid_width);
+    out.put(" x ");
+    out.putInt(info.grid_height);
+    out.put(" logic blocks.\n\nRouting:\n");
+
+    auto putNode = [&](int id, int next_switch) {
+        RRNodeType type = nodes.type(id);
+        const char* type_name = node_type_name(type);
+        out.put("Node:\t");
+        out.putInt(id);
+        out.put('\t');
+        for (size_t pad = std::strlen(type_name); pad < 6; ++pad) out.put(' ');
+        out.put(type_name);
+        out.put(" (");
+        out.putInt(nodes.x_low[id]);
+        out.put(',');
+        out.putInt(nodes.y_low[id]);
+        out.put(") ");
+        if (nodes.x_high[id] != nodes.x_low[id] || nodes.y_high[id] != nodes.y_low[id]) {
+            out.put("to (");
+            out.putInt(nodes.x_high[id]);
+            out.put(',');
+            out.putInt(nodes.y_high[id]);
+            out.put(") ");
+        }
+        out.put(ptc_label(type));
+        out.put(": ");
+        out.putInt(nodes.ptc[id]);
+        out.put("  Switch: ");
+        out.putInt(next_switch);
+        out.put('\n');
+    };
+
+    for (size_t n = 0; n < nets.size() && n < routes.size(); ++n) {
+        out.put("\n\nNet ");
+        out.putInt(static_cast<long long>(n));
+        out.put(" (");
+        out.put(nets[n].name);
+        out.put(")\n\n");
+
+        // Traceback: o nó i continua o anterior ou abre um ramo, que
+        // recomeça repetindo o nó da árvore de onde sai
+        const auto& tree = routes[n].nodes;
+        for (size_t i = 0; i < tree.size(); ++i) {
+            int parent = tree[i].parent;
+            if (i > 0 && parent != static_cast<int>(i) - 1) {
+                putNode(tree[parent].rr_node, tree[i].switch_id);
+            }
+            bool continues = i + 1 < tree.size() && tree[i + 1].parent == static_cast<int>(i);
+            putNode(tree[i].rr_node, continues ? tree[i + 1].switch_id : -1);
+        }
+        out.maybeFlush();
+    }
+    out.flush();
+
+    bool ok = !out.failed() && std::fclose(file) == 0;
+    if (!ok) std::remove(filename.c_str());
+    return ok;
+}
+
+std::vector<RouteTree> read_route_file(
+    const std::string& filename,
+    const RoutingGraph& graph,
+    const std::vector<Net>& nets
+) {
+    std::string contents;
+    if (!read_whole_file(filename, contents)) return {};
+
+    std::vector<RouteTree> routes(nets.size());
+    for (size_t i = 0; i < nets.size(); ++i) {
+        routes[i].net_id = nets[i].id;
+        routes[i].total_delay = 0.0f;
+        routes[i].routed = false;
+    }
+    std::vector<int> tree_index(graph.nodes.size(), -1);
+    NetMatcher matcher(nets);
+
+    int net = -1;       // Net atual (-1 = ignorar nós até a próxima)
+    int current = -1;   // Último nó da árvore no traceback
+    auto finishNet = [&]() {
+        return net < 0 || finish_tree(graph, nets[net], routes[net], tree_index);
+    };
+
+    const char* p = contents.data();
+    const char* end = p + contents.size();
+    while (p < end) {
+        const char* next = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!next) next = end;
+        const char* line_end = next;
+        if (line_end > p && *(line_end - 1) == '\r') --line_end;  // Fim de linha CRLF
+
+        if (line_end - p > 6 && std::memcmp(p, "Node:", 5) == 0) {
+            if (net >= 0) {
+                const char* q = p + 5;
+                while (q < line_end && (*q == ' ' || *q == '\t')) ++q;
+                long long id = -1;
+                std::from_chars(q, line_end, id);
+                if (!valid_node(graph, id)) return {};
+
+                RouteTree& tree = routes[net];
+                int index = tree_index[id];
+                if (index < 0) {
+                    index = tree.addNode(static_cast<int>(id), current, 0.0f);
+                    tree_index[id] = index;
+                }
+                current = index;
+            }
+        } else if (line_end - p > 4 && std::memcmp(p, "Net ", 4) == 0) {
+            if (!finishNet()) return {};
+            long long index = -1;
+            std::from_chars(p + 4, line_end, index);
+            const char* open = static_cast<const char*>(std::memchr(p, '(', line_end - p));
+            const char* close = line_end;
+            while (close > open && *(close - 1) != ')') --close;
+            net = open && close > open + 1 ? matcher.find(index, open + 1, close - 1 - (open + 1)) : -1;
+            if (net >= 0 && !routes[net].nodes.empty()) net = -1;  // Net repetida
+            current = -1;
+        }
+        p = next + 1;
+    }
+    if (!finishNet()) return {};
+    return routes;
+}
+
+bool write_route_binary(
+    const std::string& filename,
+    const std::vector<Net>& nets,
+    const std::vector<RouteTree>& routes
+) {
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) return false;
+
+    OutputBuffer out(file);
+    out.putRaw(ROUTE_MAGIC, sizeof(ROUTE_MAGIC));
+    out.putRaw(&ROUTE_VERSION, sizeof(ROUTE_VERSION));
+    size_t count = std::min(nets.size(), routes.size());
+    out.putVarint(count);
+
+    for (size_t n = 0; n < count; ++n) {
+        const auto& tree = routes[n].nodes;
+        out.putVarint(nets[n].name.size());
+        out.put(nets[n].name);
+        out.putVarint(tree.size());
+
+        // Ids próximos no grafo viram deltas pequenos; o pai quase sempre é o nó anterior (1)
+        int64_t previous = 0;
+        for (size_t i = 0; i < tree.size(); ++i) {
+            int64_t delta = static_cast<int64_t>(tree[i].rr_node) - previous;
+            out.putVarint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+            previous = tree[i].rr_node;
+            if (i > 0) out.putVarint(i - tree[i].parent);
+        }
+        out.maybeFlush();
+    }
+    out.flush();
+
+    bool ok = !out.failed() && std::fclose(file) == 0;
+    if (!ok) std::remove(filename.c_str());
+    return ok;
+}
+
+std::vector<RouteTree> read_route_binary(
+    const std::string& filename,
+    const RoutingGraph& graph,
+    const std::vector<Net>& nets
+) {
+    std::string contents;
+    if (!read_whole_file(filename, contents)) return {};
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(contents.data());
+    const unsigned char* end = p + contents.size();
+    uint32_t version = 0;
+    if (contents.size() < sizeof(ROUTE_MAGIC) + sizeof(version) ||
+        std::memcmp(p, ROUTE_MAGIC, sizeof(ROUTE_MAGIC)) != 0) {
+        return {};
+    }
+    std::memcpy(&version, p + sizeof(ROUTE_MAGIC), sizeof(version));
+    if (version != ROUTE_VERSION) return {};
+    p += sizeof(ROUTE_MAGIC) + sizeof(version);
+
+    bool truncated = false;
+    auto varint = [&]() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) break;
+            unsigned char byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        truncated = true;
+        return value;
+    };
+
+    std::vector<RouteTree> routes(nets.size());
+    for (size_t i = 0; i < nets.size(); ++i) {
+        routes[i].net_id = nets[i].id;
+        routes[i].total_delay = 0.0f;
+        routes[i].routed = false;
+    }
+    std::vector<int> tree_index(graph.nodes.size(), -1);
+    NetMatcher matcher(nets);
+    RouteTree skipped;
+
+    uint64_t count = varint();
+    for (uint64_t n = 0; n < count && !truncated; ++n) {
+        uint64_t name_length = varint();
+        if (truncated || name_length > static_cast<uint64_t>(end - p)) return {};
+        int net = matcher.find(static_cast<long long>(n), reinterpret_cast<const char*>(p), name_length);
+        p += name_length;
+
+        RouteTree& tree = net >= 0 && routes[net].nodes.empty() ? routes[net] : skipped;
+        uint64_t size = varint();
+        if (size > static_cast<uint64_t>(end - p)) return {};
+        tree.nodes.clear();
+        tree.nodes.reserve(size);
+        int64_t previous = 0;
+        for (uint64_t i = 0; i < size; ++i) {
+            uint64_t zigzag = varint();
+            int64_t id = previous + static_cast<int64_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+            uint64_t back = i > 0 ? varint() : 0;
+            if (truncated || !valid_node(graph, id) || (i > 0 && (back == 0 || back > i))) return {};
+            previous = id;
+            int parent = i > 0 ? static_cast<int>(i - back) : -1;
+            tree_index[id] = tree.addNode(static_cast<int>(id), parent, 0.0f);
+        }
+        if (&tree == &skipped) {
+            for (const auto& node : tree.nodes) tree_index[node.rr_node] = -1;
+        } else if (!finish_tree(graph, nets[net], tree, tree_index)) {
+            return {};
+        }
+    }
+    if (truncated) return {};
+    return routes;
+}
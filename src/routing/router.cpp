@@ -1,148 +1,779 @@
 #include "routing/router.h"
-#include <queue>
+#include "routing/partition.h"
 #include <limits>
-#include <unordered_map>
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 
-struct DijkstraNode {
-    int id;
-    float cost;
+std::vector<RouteTree> Router::route(
+    RoutingGraph& graph,
+    const std::vector<Net>& nets
+) {
+    std::vector<RouteTree> results(nets.size());
+    for (size_t i = 0; i < nets.size(); ++i) {
+        results[i].net_id = nets[i].id;
+        results[i].total_delay = 0.0f;
+        results[i].routed = false;
+    }
+    
+    graph.resetUsage();
     
-    bool operator>(const DijkstraNode& other) const {
-        return cost > other.cost;
+    // Lookahead do A* pré-calculado uma vez por chamada (vale para todas as iterações)
+    if (options_.astar_fac > 0.0f) {
+        lookahead_.build(graph, options_.lookahead_samples);
     }
-};
+    return negotiate(graph, nets, std::move(results), false);
+}
 
-std::vector<RouteTree> Router::route(
-    const RoutingGraph& graph,
-    const std::vector<Net>& nets
+std::vector<RouteTree> Router::reroute(
+    RoutingGraph& graph,
+    const std::vector<Net>& nets,
+    std::vector<RouteTree> routes
 ) {
-    std::vector<RouteTree> results;
+    routes.resize(nets.size());
+    for (size_t i = 0; i < nets.size(); ++i) {
+        routes[i].net_id = nets[i].id;
+        if (routes[i].nodes.empty()) {
+            routes[i].sink_branches.clear();
+            routes[i].total_delay = 0.0f;
+            routes[i].routed = false;
+        }
+    }
     
-    // Para cada net, rotear individualmente
-    for (const auto& net : nets) {
-        RouteTree route_tree;
-        route_tree.net_id = net.id;
-        route_tree.total_delay = 0.0f;
-        route_tree.routed = false;
+    // O lookahead só depende do grafo: reaproveitado entre chamadas
+    if (options_.astar_fac > 0.0f && lookahead_.empty()) {
+        lookahead_.build(graph, options_.lookahead_samples);
+    }
+    
+    // Criticidades já na 1a iteração, a partir das rotas preservadas
+    if (timing_) {
+        for (size_t i = 0; i < nets.size(); ++i) {
+            if (routes[i].routed) timing_->updateNet(graph, static_cast<int>(i), routes[i]);
+        }
+        timing_->update();
+    }
+    return negotiate(graph, nets, std::move(routes), true);
+}
+
+std::vector<RouteTree> Router::negotiate(
+    RoutingGraph& graph,
+    const std::vector<Net>& nets,
+    std::vector<RouteTree> results,
+    bool incremental
+) {
+    hist_cost_.assign(graph.nodes.size(), 1.0f);
+    pres_fac_ = options_.initial_pres_fac;
+    legal_ = false;
+    iterations_ = 0;
+    stats_ = RouterStats();
+    
+    BoundingBox device = deviceBox(graph);
+    net_margin_.assign(nets.size(), options_.bb_margin);
+    net_ms_.assign(nets.size(), 0.0);
+    connections_.resize(nets.size());
+    for (size_t i = 0; i < nets.size(); ++i) {
+        connections_[i].assign(nets[i].sinks.size(), ConnectionState());
+        if (results[i].routed) updateConnections(graph, static_cast<int>(i), results[i]);
+    }
+    
+    // Um workspace por thread; o da thread 0 também atende a passada serial
+    workspaces_.resize(std::max(1, options_.num_threads));
+    for (auto& workspace : workspaces_) {
+        workspace.resize(graph.nodes.size());
+        workspace.stats = RouterStats();
+    }
+    
+    // Modo paralelo: regiões disjuntas do mesmo nível roteadas em threads diferentes
+    NetPartitioner partitioner;
+    if (options_.num_threads > 1) {
+        if (!pool_ || pool_->size() != options_.num_threads) {
+            pool_.reset(new ThreadPool(options_.num_threads));
+        }
         
-        std::cout << "Roteando net " << net.name 
-                  << " (driver: " << net.driver 
-                  << ", sinks: " << net.sinks.size() << ")" << std::endl;
+        // Folhas suficientes para ocupar todas as threads
+        int max_level = static_cast<int>(std::ceil(std::log2(options_.num_threads))) + 2;
+        partitioner.build(device, max_level);
         
-        // Verificar se temos driver e sinks válidos
-        if (net.driver >= 0 && !net.sinks.empty()) {
-            // Encontrar caminho usando Dijkstra simplificado
-            auto path = findPath(graph, net.driver, net.sinks);
-            
-            if (!path.empty()) {
-                route_tree.nodes = path;
-                route_tree.routed = true;
-                
-                // Calcular atraso total (simplificado)
-                for (int node_id : path) {
-                    if (node_id < graph.nodes.size()) {
-                        route_tree.total_delay += graph.nodes[node_id].delay;
-                    }
-                }
-                
-                std::cout << "  Net roteada com " << path.size() 
-                          << " nós, delay: " << route_tree.total_delay 
-                          << " ns" << std::endl;
+        std::vector<BoundingBox> net_boxes;
+        for (const auto& net : nets) {
+            net_boxes.push_back(netBoundingBox(graph, net, options_.bb_margin, device));
+        }
+        partitioner.assign(net_boxes);
+    }
+    
+    // Nets da raiz e as que não couberam na própria região: passada serial
+    std::vector<char> serial(nets.size(), 0);
+    if (options_.num_threads > 1) {
+        for (int i : partitioner.region(0).nets) serial[i] = 1;
+    }
+    
+    // Nets sem driver são um erro de mapeamento: reportadas uma vez e fora
+    // da negociação, para não prender o laço até max_iterations
+    std::vector<char> no_driver(nets.size(), 0);
+    int missing_drivers = 0;
+    for (size_t i = 0; i < nets.size(); ++i) {
+        if (nets[i].driver < 0) {
+            no_driver[i] = 1;
+            missing_drivers++;
+        }
+    }
+    if (missing_drivers > 0) {
+        std::cout << "  ERRO: " << missing_drivers << " nets sem driver não serão roteadas"
+                  << std::endl;
+    }
+    
+    for (int iter = 1; iter <= options_.max_iterations; ++iter) {
+        iterations_ = iter;
+        
+        // Rip-up e reroute por conexão: na 1a iteração, todas; depois, só
+        // as ilegais ou críticas de cada net, preservando os ramos sãos
+        std::atomic<int> rerouted{0};
+        std::atomic<long long> rerouted_connections{0};
+        std::vector<char> changed(nets.size(), 0);
+        auto reroute = [&](int i, const BoundingBox& region, SearchWorkspace& workspace) {
+            if (no_driver[i]) return;
+            int ripped;
+            if ((iter > 1 || incremental) && results[i].routed) {
+                ripped = ripUpConnections(graph, i, results[i]);
+                if (ripped == 0) return;
             } else {
-                std::cout << "  ERRO: Net não pôde ser roteada!" << std::endl;
+                ripUp(graph, results[i]);
+                ripped = static_cast<int>(nets[i].sinks.size());
+            }
+#if ROUTER_PROFILING
+            auto start = std::chrono::steady_clock::now();
+#endif
+            routeNetGrowing(graph, nets[i], i, results[i], region, workspace);
+#if ROUTER_PROFILING
+            net_ms_[i] += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+#endif
+            changed[i] = 1;
+            rerouted++;
+            rerouted_connections += ripped;
+        };
+        
+        if (options_.num_threads > 1) {
+            // Das regiões mais profundas para a raiz; a raiz (nets que cruzam
+            // o primeiro corte) é a passada serial de limpeza
+            for (int level = partitioner.numLevels() - 1; level >= 1; --level) {
+                const auto& regions = partitioner.level(level);
+                pool_->run(static_cast<int>(regions.size()), [&](int r, int worker) {
+                    const PartitionRegion& region = partitioner.region(regions[r]);
+                    for (int i : region.nets) {
+                        if (serial[i]) continue;
+                        reroute(i, region.box, workspaces_[worker]);
+                        if (!results[i].routed) serial[i] = 1;
+                    }
+                });
+            }
+            for (size_t i = 0; i < nets.size(); ++i) {
+                if (serial[i]) reroute(i, device, workspaces_[0]);
             }
         } else {
-            std::cout << "  Net inválida (driver ou sinks faltando)" << std::endl;
+            for (size_t i = 0; i < nets.size(); ++i) {
+                reroute(i, device, workspaces_[0]);
+            }
+        }
+        
+        // Acumular custo histórico só nos nós sobreusados (sem varrer o grafo)
+        OveruseSummary overuse = graph.occupancy.summary();
+        for (int id : overuse.nodes) {
+            hist_cost_[id] += options_.hist_fac * graph.occupancy.overuse(id);
+        }
+        int overused = static_cast<int>(overuse.nodes.size());
+        
+        bool all_routed = true;
+        for (size_t i = 0; i < nets.size(); ++i) {
+            if (!no_driver[i] && !results[i].routed) all_routed = false;
+        }
+        
+        // Timing incremental: só as conexões das nets reroteadas mudam
+        if (timing_) {
+            for (size_t i = 0; i < nets.size(); ++i) {
+                if (changed[i]) timing_->updateNet(graph, static_cast<int>(i), results[i]);
+            }
+            timing_->update();
+        }
+        
+        // Estado das conexões depois da STA, para o atraso vir do mesmo
+        // modelo que a criticidade
+        for (size_t i = 0; i < nets.size(); ++i) {
+            if (changed[i]) updateConnections(graph, static_cast<int>(i), results[i]);
         }
         
-        results.push_back(route_tree);
+        std::cout << "Iteração " << iter << ": " << rerouted.load() << " nets reroteadas ("
+                  << rerouted_connections.load() << " conexões), "
+                  << overused << " nós sobreusados";
+        if (timing_) {
+            std::cout << ", caminho crítico " << timing_->criticalPathDelay() << " ns";
+        }
+        std::cout << std::endl;
+        
+        if (overused == 0 && all_routed) {
+            legal_ = missing_drivers == 0;
+            break;
+        }
+        
+        pres_fac_ = std::min(pres_fac_ * options_.pres_fac_mult, options_.max_pres_fac);
+    }
+    
+    for (const auto& workspace : workspaces_) {
+        stats_.merge(workspace.stats);
+    }
+    
+    if (!legal_) {
+        std::cout << "  AVISO: roteamento ilegal após " << iterations_
+                  << " iterações" << std::endl;
     }
     
     return results;
 }
 
+void Router::routeNetGrowing(RoutingGraph& graph, const Net& net, int net_index,
+                             RouteTree& route_tree, const BoundingBox& region,
+                             SearchWorkspace& workspace) {
+    while (true) {
+        SearchBounds bounds;
+        bounds.net_box = netBoundingBox(graph, net, net_margin_[net_index], region);
+        bounds.region = region;
+        
+        size_t first_new = route_tree.nodes.size();
+        routeNet(graph, net, net_index, route_tree, bounds, workspace);
+        if (route_tree.routed || bounds.net_box.contains(region)) return;
+        
+        // Falhou dentro da caixa: desfazer só os ramos desta tentativa,
+        // preservando os mantidos de iterações anteriores, e ampliar
+        ripUpFrom(graph, route_tree, first_new);
+        net_margin_[net_index] = net_margin_[net_index] * 2 + 1;
+    }
+}
+
+void Router::routeNet(RoutingGraph& graph, const Net& net, int net_index, RouteTree& route_tree,
+                      const SearchBounds& bounds, SearchWorkspace& workspace) {
+    // Log da net montado localmente e emitido de uma vez (rotas em paralelo)
+    std::ostringstream log;
+    if (options_.log_nets) {
+        log << "Roteando net " << net.name 
+            << " (driver: " << net.driver 
+            << ", sinks: " << net.sinks.size() << ")" << std::endl;
+    }
+    
+    // Sem driver não há fonte (negotiate já tira essas nets da negociação).
+    // Sem sinks, a árvore só com a fonte já é a rota completa
+    if (net.driver < 0) {
+        if (options_.log_nets) {
+            log << "  Net inválida (driver faltando)" << std::endl;
+            flushLog(log);
+        }
+        return;
+    }
+    
+    // Raiz da árvore na fonte, se ela ainda não existir. A ocupação dos
+    // nós novos é registrada de uma vez ao fim (a busca da própria net
+    // ignora os nós da árvore)
+    RRNodeStore& nodes = graph.nodes;
+    size_t first_new = route_tree.nodes.size();
+    if (route_tree.nodes.empty()) {
+        route_tree.addNode(net.driver, -1, nodes.delay[net.driver]);
+        route_tree.sink_branches.assign(net.sinks.size(), -1);
+        route_tree.total_delay = 0.0f;
+    }
+    
+    workspace.beginTree();
+    for (size_t i = 0; i < route_tree.nodes.size(); ++i) {
+        workspace.setTreeIndex(route_tree.nodes[i].rr_node, static_cast<int>(i));
+    }
+    
+    // Sinks mais próximos da fonte primeiro: ramos curtos viram pontos de partida
+    int driver_x = nodes.x_low[net.driver], driver_y = nodes.y_low[net.driver];
+    auto distance = [&](int id) {
+        return std::abs(nodes.x_low[id] - driver_x) + std::abs(nodes.y_low[id] - driver_y);
+    };
+    std::vector<int> order;
+    for (size_t i = 0; i < net.sinks.size(); ++i) {
+        if (route_tree.sink_branches[i] < 0) order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return distance(net.sinks[a]) < distance(net.sinks[b]);
+    });
+    
+    bool all_routed = true;
+    for (int sink_idx : order) {
+        int sink_id = net.sinks[sink_idx];
+        
+        // Sink já alcançado por outro ramo (ex.: sinks equivalentes)
+        int reached = workspace.treeIndex(sink_id);
+        if (reached >= 0) {
+            route_tree.sink_branches[sink_idx] = reached;
+            continue;
+        }
+        
+        auto path = findPath(graph, route_tree, sink_id, connectionCriticality(net_index, sink_idx),
+                             bounds, workspace);
+        if (path.empty()) {
+            all_routed = false;
+            continue;
+        }
+        
+        // Anexar o novo ramo à árvore a partir do ponto de conexão
+        int parent = workspace.treeIndex(path[0]);
+        for (size_t i = 1; i < path.size(); ++i) {
+            int from = path[i - 1], to = path[i];
+            RREdgeView edge = graph.edge(graph.findEdge(from, to));
+            float delay = route_tree.nodes[parent].delay + edge.delay + nodes.delay[to];
+            parent = route_tree.addNode(to, parent, delay, edge.switch_id);
+            workspace.setTreeIndex(to, parent);
+        }
+        route_tree.sink_branches[sink_idx] = parent;
+        route_tree.total_delay = std::max(route_tree.total_delay, route_tree.nodes[parent].delay);
+    }
+    
+    for (size_t i = first_new; i < route_tree.nodes.size(); ++i) {
+        graph.occupancy.add(route_tree.nodes[i].rr_node, 1);
+    }
+    
+    if (!all_routed) {
+        if (options_.log_nets) {
+            log << "  ERRO: Net não pôde ser roteada!" << std::endl;
+            flushLog(log);
+        }
+        return;
+    }
+    
+    route_tree.routed = true;
+    if (options_.log_nets) {
+        log << "  Net roteada com " << route_tree.nodes.size() 
+            << " nós, delay: " << route_tree.total_delay 
+            << " ns" << std::endl;
+        flushLog(log);
+    }
+}
+
+void Router::ripUp(RoutingGraph& graph, RouteTree& route_tree) {
+    graph.occupancy.ripUp(route_tree);
+    route_tree.nodes.clear();
+    route_tree.sink_branches.clear();
+    route_tree.total_delay = 0.0f;
+    route_tree.routed = false;
+}
+
+void Router::ripUpFrom(RoutingGraph& graph, RouteTree& route_tree, size_t first_new) {
+    if (first_new == 0) {
+        ripUp(graph, route_tree);
+        return;
+    }
+    for (size_t i = first_new; i < route_tree.nodes.size(); ++i) {
+        graph.occupancy.add(route_tree.nodes[i].rr_node, -1);
+    }
+    route_tree.nodes.resize(first_new);
+    
+    route_tree.total_delay = 0.0f;
+    for (int& branch : route_tree.sink_branches) {
+        if (branch >= static_cast<int>(first_new)) branch = -1;
+        if (branch < 0) continue;
+        route_tree.total_delay = std::max(route_tree.total_delay, route_tree.nodes[branch].delay);
+    }
+    route_tree.routed = false;
+}
+
+std::vector<char> Router::illegalPaths(const RoutingGraph& graph, const RouteTree& route_tree) {
+    // O pai sempre aparece antes dos filhos
+    std::vector<char> illegal(route_tree.nodes.size(), 0);
+    for (size_t i = 0; i < route_tree.nodes.size(); ++i) {
+        const RouteTreeNode& node = route_tree.nodes[i];
+        illegal[i] = graph.occupancy.overuse(node.rr_node) > 0 ||
+                     (node.parent >= 0 && illegal[node.parent]);
+    }
+    return illegal;
+}
+
+int Router::ripUpConnections(RoutingGraph& graph, int net_index, RouteTree& route_tree) {
+    const size_t size = route_tree.nodes.size();
+    std::vector<char> illegal = illegalPaths(graph, route_tree);
+    
+    // Conexões mantidas marcam o caminho até a raiz
+    std::vector<ConnectionState>& connections = connections_[net_index];
+    std::vector<char> keep(size, 0);
+    keep[0] = 1;
+    int ripped = 0;
+    for (size_t k = 0; k < connections.size(); ++k) {
+        int branch = route_tree.sink_branches[k];
+        ConnectionState& connection = connections[k];
+        connection.legal = !illegal[branch];
+        connection.criticality = connectionCriticality(net_index, static_cast<int>(k));
+        bool critical = connection.criticality >= options_.reroute_criticality &&
+                        connection.delay > options_.reroute_delay_slack * connection.best_delay;
+        if (!connection.legal || critical) {
+            route_tree.sink_branches[k] = -1;
+            ripped++;
+            continue;
+        }
+        for (int i = branch; i >= 0 && !keep[i]; i = route_tree.nodes[i].parent) keep[i] = 1;
+    }
+    if (ripped == 0) return 0;
+    
+    // Compactar a árvore preservando a ordem (pais antes dos filhos)
+    std::vector<int> remap(size, -1);
+    std::vector<RouteTreeNode> kept;
+    kept.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        RouteTreeNode node = route_tree.nodes[i];
+        if (!keep[i]) {
+            graph.occupancy.add(node.rr_node, -1);
+            continue;
+        }
+        remap[i] = static_cast<int>(kept.size());
+        if (node.parent >= 0) node.parent = remap[node.parent];
+        kept.push_back(node);
+    }
+    route_tree.nodes.swap(kept);
+    
+    route_tree.total_delay = 0.0f;
+    for (int& branch : route_tree.sink_branches) {
+        if (branch < 0) continue;
+        branch = remap[branch];
+        route_tree.total_delay = std::max(route_tree.total_delay, route_tree.nodes[branch].delay);
+    }
+    route_tree.routed = false;
+    return ripped;
+}
+
+void Router::updateConnections(const RoutingGraph& graph, int net_index,
+                               const RouteTree& route_tree) {
+    std::vector<ConnectionState>& connections = connections_[net_index];
+    std::vector<char> illegal = illegalPaths(graph, route_tree);
+    for (size_t k = 0; k < connections.size(); ++k) {
+        int branch = k < route_tree.sink_branches.size() ? route_tree.sink_branches[k] : -1;
+        ConnectionState& connection = connections[k];
+        if (branch < 0) {
+            connection.legal = false;
+            continue;
+        }
+        connection.legal = !illegal[branch];
+        
+        // Com STA, o atraso é o Elmore do analisador, o mesmo que define a
+        // criticidade; árvores incompletas ainda não foram analisadas
+        if (timing_ && !route_tree.routed) continue;
+        connection.delay = timing_ ? timing_->connectionDelay(net_index, static_cast<int>(k))
+                                   : route_tree.nodes[branch].delay;
+        if (connection.best_delay <= 0.0f || connection.delay < connection.best_delay) {
+            connection.best_delay = connection.delay;
+        }
+    }
+}
+
 std::vector<int> Router::findPath(
     const RoutingGraph& graph,
-    int source_id,
-    const std::vector<int>& sinks_ids
+    const RouteTree& route_tree,
+    int sink_id,
+    float criticality,
+    const SearchBounds& bounds,
+    SearchWorkspace& workspace
 ) {
-    // Dijkstra simplificado para múltiplos sinks
-    std::priority_queue<DijkstraNode, std::vector<DijkstraNode>, 
-                       std::greater<DijkstraNode>> pq;
+    // Conexões longas saindo só da fonte: frentes da fonte e do sink
+    // exploram cada uma cerca de metade da distância
+    int source_id = route_tree.nodes[0].rr_node;
+    const RRNodeStore& nodes = graph.nodes;
+    int span = std::abs(nodes.x_low[sink_id] - nodes.x_low[source_id]) +
+               std::abs(nodes.y_low[sink_id] - nodes.y_low[source_id]);
+    // Só sem lookahead: a regra de parada exige potenciais consistentes, e o
+    // lookahead ponderado por astar_fac não garante isso
+    bool bidirectional = options_.bidir_min_span > 0 && options_.astar_fac <= 0.0f &&
+                         route_tree.nodes.size() == 1 && span >= options_.bidir_min_span;
     
-    std::unordered_map<int, float> dist;
-    std::unordered_map<int, int> prev;
-    std::set<int> sinks_set(sinks_ids.begin(), sinks_ids.end());
-    std::vector<int> path;
+    auto search = [&](auto& forward, auto& backward) {
+        if (bidirectional) {
+            return searchBidirectional(forward, backward, graph, source_id, sink_id, criticality,
+                                       bounds, workspace);
+        }
+        return searchPath(forward, graph, route_tree, sink_id, criticality, bounds, workspace);
+    };
     
-    // Inicializar distâncias
-    for (size_t i = 0; i < graph.nodes.size(); ++i) {
-        dist[i] = std::numeric_limits<float>::infinity();
+    SearchQueues& queues = workspace.queues;
+    SearchQueues& reverse = workspace.reverse_queues;
+    switch (options_.queue) {
+        case QueueKind::BINARY_HEAP:
+            return search(queues.binary_heap, reverse.binary_heap);
+        case QueueKind::RADIX:
+            queues.radix_queue.setResolution(options_.queue_resolution);
+            reverse.radix_queue.setResolution(options_.queue_resolution);
+            return search(queues.radix_queue, reverse.radix_queue);
+        default:
+            return search(queues.four_ary_heap, reverse.four_ary_heap);
     }
+}
+
+template <typename Queue>
+std::vector<int> Router::searchPath(
+    Queue& queue,
+    const RoutingGraph& graph,
+    const RouteTree& route_tree,
+    int sink_id,
+    float criticality,
+    const SearchBounds& bounds,
+    SearchWorkspace& workspace
+) {
+    // Dijkstra (ou A* com lookahead) da árvore parcial até o sink.
+    // O workspace reinicia em O(1): o custo depende só dos nós explorados
+    workspace.beginSearch();
+    queue.clear();
+    RouterStats& stats = workspace.stats;
+    std::vector<int> path;
     
-    dist[source_id] = 0.0f;
-    pq.push({source_id, 0.0f});
+    // Semear com todos os nós da árvore; o atraso já acumulado entra no termo de timing
+    stats.connections++;
+    for (const auto& tree_node : route_tree.nodes) {
+        float backward_cost = criticality * tree_node.delay;
+        workspace.setCost(tree_node.rr_node, backward_cost, -1);
+        queue.push({tree_node.rr_node,
+                    backward_cost + expectedCost(graph, tree_node.rr_node, sink_id, criticality),
+                    backward_cost});
+        PROFILE_COUNT(stats.heap_pushes);
+    }
     
-    int target_reached = -1;
+    bool target_reached = false;
     
-    // Executar Dijkstra
-    while (!pq.empty()) {
-        auto current = pq.top();
-        pq.pop();
+    // Executar Dijkstra/A*
+    while (!queue.empty()) {
+        HeapEntry current = queue.pop();
+        PROFILE_COUNT(stats.heap_pops);
         
-        // Se chegamos em algum sink, parar
-        if (sinks_set.find(current.id) != sinks_set.end()) {
-            target_reached = current.id;
+        // Entrada antiga: o nó já saiu da fila com custo menor
+        if (current.backward_cost > workspace.cost(current.id)) {
+            PROFILE_COUNT(stats.stale_pops);
+            continue;
+        }
+        
+        if (current.id == sink_id) {
+            target_reached = true;
             break;
         }
         
-        // Explorar vizinhos
-        const auto& neighbors = graph.getNeighbors(current.id);
-        for (int neighbor_id : neighbors) {
-            if (neighbor_id < graph.nodes.size()) {
-                const auto& neighbor = graph.nodes[neighbor_id];
-                
-                // Custo: atraso do nó + atraso da aresta
-                float edge_delay = 0.0f;
-                for (const auto& edge : graph.edges) {
-                    if (edge.from_node == current.id && edge.to_node == neighbor_id) {
-                        edge_delay = edge.delay;
-                        break;
-                    }
-                }
-                
-                float new_cost = current.cost + neighbor.delay + edge_delay;
-                
-                if (new_cost < dist[neighbor_id]) {
-                    dist[neighbor_id] = new_cost;
-                    prev[neighbor_id] = current.id;
-                    pq.push({neighbor_id, new_cost});
-                }
+        PROFILE_COUNT(stats.nodes_expanded);
+#if ROUTER_PROFILING
+        if (workspace.markExpanded(current.id)) stats.reexpansions++;
+#endif
+        
+        // Explorar vizinhos: destino, atraso e switch em O(1) por aresta
+        for (auto edge : graph.outEdges(current.id)) {
+            int neighbor_id = edge.node;
+            
+            // Fora da caixa da net ou da região da thread
+            if (!bounds.allows(graph.nodes, neighbor_id)) continue;
+            
+            // Nós da árvore já são pontos de partida
+            if (workspace.treeIndex(neighbor_id) >= 0) continue;
+            PROFILE_COUNT(stats.edges_relaxed);
+            
+            // Custo: congestionamento/atraso do nó + atraso da aresta
+            float new_cost = current.backward_cost
+                           + getNodeCost(graph, neighbor_id, criticality)
+                           + criticality * edge.delay;
+            
+            if (new_cost < workspace.cost(neighbor_id)) {
+                workspace.setCost(neighbor_id, new_cost, current.id);
+                queue.push({neighbor_id,
+                            new_cost + expectedCost(graph, neighbor_id, sink_id, criticality),
+                            new_cost});
+                PROFILE_COUNT(stats.heap_pushes);
             }
         }
     }
     
-    // Reconstruir caminho
-    if (target_reached != -1) {
-        int current = target_reached;
-        while (current != source_id) {
+    // Reconstruir o ramo até o nó da árvore onde começou
+    if (target_reached) {
+        for (int current = sink_id; current != -1; current = workspace.prev(current)) {
             path.push_back(current);
-            current = prev[current];
         }
-        path.push_back(source_id);
         std::reverse(path.begin(), path.end());
     }
     
     return path;
 }
 
-float Router::getNodeCost(const RRNode& node, float criticality) {
+template <typename Queue>
+std::vector<int> Router::searchBidirectional(
+    Queue& forward,
+    Queue& backward,
+    const RoutingGraph& graph,
+    int source_id,
+    int sink_id,
+    float criticality,
+    const SearchBounds& bounds,
+    SearchWorkspace& workspace
+) {
+    // Custo de um caminho: soma, por aresta u -> v, de getNodeCost(v) +
+    // criticality * atraso(u -> v). A frente direta guarda o custo desde a
+    // fonte (incluindo o do nó); a reversa, o custo do nó até o sink (sem
+    // o do nó). No encontro em x, o custo total é cost(x) + reverseCost(x).
+    // Dijkstra nas duas frentes, sem heurística (findPath só chega aqui com
+    // astar_fac = 0)
+    workspace.beginSearch();
+    workspace.enableReverse();
+    forward.clear();
+    backward.clear();
+    RouterStats& stats = workspace.stats;
+    stats.connections++;
+    stats.bidirectional++;
+    
+    const RRNodeStore& nodes = graph.nodes;
+    float source_cost = criticality * nodes.delay[source_id];
+    workspace.setCost(source_id, source_cost, -1);
+    forward.push({source_id, source_cost, source_cost});
+    workspace.setReverseCost(sink_id, 0.0f, -1);
+    backward.push({sink_id, 0.0f, 0.0f});
+    PROFILE_ADD(stats.heap_pushes, 2);
+    
+    // Melhor caminho completo já visto (mu) e o nó de encontro
+    float best = std::numeric_limits<float>::infinity();
+    int meeting = -1;
+    auto meet = [&](int node) {
+        float total = workspace.cost(node) + workspace.reverseCost(node);
+        if (total < best) {
+            best = total;
+            meeting = node;
+        }
+    };
+    
+    while (!forward.empty() && !backward.empty()) {
+        const HeapEntry& top_forward = forward.top();
+        const HeapEntry& top_backward = backward.top();
+        
+        // Parada: a soma das menores chaves das duas frentes já alcança mu
+        if (top_forward.cost + top_backward.cost >= best) break;
+        
+        // Avança a frente de menor chave
+        bool expand_forward = top_forward.cost <= top_backward.cost;
+        PROFILE_COUNT(stats.heap_pops);
+        
+        if (expand_forward) {
+            HeapEntry current = forward.pop();
+            if (current.backward_cost > workspace.cost(current.id)) {
+                PROFILE_COUNT(stats.stale_pops);
+                continue;
+            }
+            PROFILE_COUNT(stats.nodes_expanded);
+            
+            for (auto edge : graph.outEdges(current.id)) {
+                int neighbor_id = edge.node;
+                if (!bounds.allows(nodes, neighbor_id)) continue;
+                if (workspace.treeIndex(neighbor_id) >= 0) continue;
+                PROFILE_COUNT(stats.edges_relaxed);
+                
+                float new_cost = current.backward_cost
+                               + getNodeCost(graph, neighbor_id, criticality)
+                               + criticality * edge.delay;
+                if (new_cost < workspace.cost(neighbor_id)) {
+                    workspace.setCost(neighbor_id, new_cost, current.id);
+                    meet(neighbor_id);
+                    forward.push({neighbor_id, new_cost, new_cost});
+                    PROFILE_COUNT(stats.heap_pushes);
+                }
+            }
+        } else {
+            HeapEntry current = backward.pop();
+            if (current.backward_cost > workspace.reverseCost(current.id)) {
+                PROFILE_COUNT(stats.stale_pops);
+                continue;
+            }
+            PROFILE_COUNT(stats.nodes_expanded);
+            
+            // Entrar em current custa o mesmo para todo predecessor
+            float enter_cost = current.backward_cost + getNodeCost(graph, current.id, criticality);
+            for (auto edge : graph.inEdges(current.id)) {
+                int neighbor_id = edge.node;
+                if (!bounds.allows(nodes, neighbor_id)) continue;
+                PROFILE_COUNT(stats.edges_relaxed);
+                
+                float new_cost = enter_cost + criticality * edge.delay;
+                if (new_cost < workspace.reverseCost(neighbor_id)) {
+                    workspace.setReverseCost(neighbor_id, new_cost, current.id);
+                    meet(neighbor_id);
+                    // A fonte é o ponto de partida da outra frente: não se expande
+                    if (neighbor_id == source_id) continue;
+                    backward.push({neighbor_id, new_cost, new_cost});
+                    PROFILE_COUNT(stats.heap_pushes);
+                }
+            }
+        }
+    }
+    
+    // Ramo: fonte -> encontro pelos predecessores, encontro -> sink pelos sucessores
+    std::vector<int> path;
+    if (meeting < 0) return path;
+    for (int current = meeting; current != -1; current = workspace.prev(current)) {
+        path.push_back(current);
+    }
+    std::reverse(path.begin(), path.end());
+    for (int current = workspace.next(meeting); current != -1; current = workspace.next(current)) {
+        path.push_back(current);
+    }
+    return path;
+}
+
+float Router::expectedCost(const RoutingGraph& graph, int node_id, int sink_id,
+                           float criticality) const {
+    if (options_.astar_fac <= 0.0f || lookahead_.empty()) return 0.0f;
+    
+    return options_.astar_fac * lookahead_.estimate(graph, node_id, graph.nodes.x_low[sink_id],
+                                                    graph.nodes.y_low[sink_id], criticality);
+}
+
+float Router::connectionCriticality(int net_index, int sink_index) const {
+    if (!timing_ || !timing_->ready()) return options_.criticality;
+    return timing_->criticality(net_index, sink_index);
+}
+
+float Router::getNodeCost(const RoutingGraph& graph, int id, float criticality) {
+    const RRNodeStore& nodes = graph.nodes;
     // Custo base + penalidade por congestionamento
-    float base_cost = node.base_cost > 0 ? node.base_cost : 1.0f;
-    float congestion_cost = 1.0f + node.used;
+    float base_cost = nodes.base_cost[id] > 0 ? nodes.base_cost[id] : 1.0f;
+    
+    // Congestionamento presente: sobreuso que resultaria de ocupar o nó
+    int overuse = graph.occupancy.used(id) + 1 - graph.occupancy.capacity(id);
+    float pres_cost = 1.0f + (overuse > 0 ? pres_fac_ * overuse : 0.0f);
+    float congestion_cost = base_cost * hist_cost_[id] * pres_cost;
     
     // Balanceamento timing/congestionamento
-    return (criticality * node.delay) + ((1.0f - criticality) * base_cost * congestion_cost);
-}
\ No newline at end of file
+    return (criticality * nodes.delay[id]) + ((1.0f - criticality) * congestion_cost);
+}
+
+void Router::flushLog(const std::ostringstream& log) {
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    std::cout << log.str();
+}
+
+BoundingBox Router::deviceBox(const RoutingGraph& graph) {
+    BoundingBox box = {0, 0, 0, 0};
+    for (size_t id = 0; id < graph.nodes.size(); ++id) {
+        box.x_max = std::max<int>(box.x_max, graph.nodes.x_high[id]);
+        box.y_max = std::max<int>(box.y_max, graph.nodes.y_high[id]);
+    }
+    return box;
+}
+
+BoundingBox Router::netBoundingBox(const RoutingGraph& graph, const Net& net,
+                                   int margin, const BoundingBox& clip) {
+    if (net.driver < 0) return clip;
+    
+    const RRNodeStore& nodes = graph.nodes;
+    BoundingBox box = {nodes.x_low[net.driver], nodes.y_low[net.driver],
+                       nodes.x_high[net.driver], nodes.y_high[net.driver]};
+    for (int sink_id : net.sinks) {
+        box.x_min = std::min<int>(box.x_min, nodes.x_low[sink_id]);
+        box.y_min = std::min<int>(box.y_min, nodes.y_low[sink_id]);
+        box.x_max = std::max<int>(box.x_max, nodes.x_high[sink_id]);
+        box.y_max = std::max<int>(box.y_max, nodes.y_high[sink_id]);
+    }
+    
+    box.x_min = std::max(box.x_min - margin, clip.x_min);
+    box.y_min = std::max(box.y_min - margin, clip.y_min);
+    box.x_max = std::min(box.x_max + margin, clip.x_max);
+    box.y_max = std::min(box.y_max + margin, clip.y_max);
+    return box;
+}
@@ -0,0 +1,57 @@
+#include "routing/thread_pool.h"
+
+ThreadPool::ThreadPool(int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int count, const std::function<void(int, int)>& task) {
+    if (count <= 0) return;
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    active_ = size();
+    generation_++;
+    start_cv_.notify_all();
+    
+    done_cv_.wait(lock, [this] { return active_ == 0; });
+    task_ = nullptr;
+}
+
+void ThreadPool::workerLoop(int worker) {
+    long seen = 0;
+    while (true) {
+        const std::function<void(int, int)>* task;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            task = task_;
+            count = count_;
+        }
+        
+        // Distribuição dinâmica dos índices entre as threads
+        for (int i = next_++; i < count; i = next_++) {
+            (*task)(i, worker);
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0) done_cv_.notify_one();
+    }
+}
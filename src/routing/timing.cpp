@@ -0,0 +1,340 @@
+#include "routing/timing.h"
+#include <algorithm>
+#include <cmath>
+
+void TimingAnalyzer::build(const FPGAArchitecture& arch, const PackedNetlist& netlist,
+                           const std::vector<Net>& nets, const TimingOptions& options) {
+    options_ = options;
+    switches_ = arch.switches;
+    switch_buffered_.assign(switches_.size(), 0);
+    for (size_t s = 0; s < switches_.size(); ++s) {
+        switch_buffered_[s] = switches_[s].type != "pass_gate" && switches_[s].type != "short";
+    }
+
+    // Conexões em ordem de net/sink
+    int num_blocks = static_cast<int>(netlist.blocks.size());
+    conn_begin_.assign(1, 0);
+    conn_driver_.clear();
+    conn_sink_.clear();
+    orphan_conns_.clear();
+    for (const auto& net : nets) {
+        for (size_t k = 0; k < net.sinks.size(); ++k) {
+            int sink = k < net.sink_blocks.size() ? net.sink_blocks[k] : -1;
+            if (net.driver_block < 0) orphan_conns_.push_back(static_cast<int>(conn_driver_.size()));
+            conn_driver_.push_back(net.driver_block);
+            conn_sink_.push_back(sink);
+            num_blocks = std::max(num_blocks, std::max(net.driver_block, sink) + 1);
+        }
+        conn_begin_.push_back(static_cast<int>(conn_driver_.size()));
+    }
+    conn_delay_.assign(conn_driver_.size(), 0.0f);
+
+    boundary_.assign(num_blocks, 0);
+    for (size_t b = 0; b < netlist.blocks.size(); ++b) {
+        int type = netlist.blocks[b].type;
+        if (type >= 0 && netlist.block_types[type] == "io") boundary_[b] = 1;
+    }
+
+    // Entradas e saídas de cada bloco em CSR
+    fanin_begin_.assign(num_blocks + 1, 0);
+    fanout_begin_.assign(num_blocks + 1, 0);
+    for (size_t c = 0; c < conn_driver_.size(); ++c) {
+        if (conn_sink_[c] >= 0) fanin_begin_[conn_sink_[c] + 1]++;
+        if (conn_driver_[c] >= 0) fanout_begin_[conn_driver_[c] + 1]++;
+    }
+    for (int b = 0; b < num_blocks; ++b) {
+        fanin_begin_[b + 1] += fanin_begin_[b];
+        fanout_begin_[b + 1] += fanout_begin_[b];
+    }
+    fanin_.resize(fanin_begin_[num_blocks]);
+    fanout_.resize(fanout_begin_[num_blocks]);
+    std::vector<int> fanin_pos(fanin_begin_.begin(), fanin_begin_.end() - 1);
+    std::vector<int> fanout_pos(fanout_begin_.begin(), fanout_begin_.end() - 1);
+    for (size_t c = 0; c < conn_driver_.size(); ++c) {
+        if (conn_sink_[c] >= 0) fanin_[fanin_pos[conn_sink_[c]]++] = static_cast<int>(c);
+        if (conn_driver_[c] >= 0) fanout_[fanout_pos[conn_driver_[c]]++] = static_cast<int>(c);
+    }
+
+    // Ordem topológica (Kahn) pelas arestas que chegam em blocos combinacionais.
+    // Sem bloco livre, o próximo bloco não visitado é cortado (vira início/fim)
+    std::vector<int> pending(num_blocks, 0);
+    for (size_t c = 0; c < conn_driver_.size(); ++c) {
+        if (conn_driver_[c] >= 0 && conn_sink_[c] >= 0 && !boundary_[conn_sink_[c]]) {
+            pending[conn_sink_[c]]++;
+        }
+    }
+    topo_index_.assign(num_blocks, -1);
+    std::vector<int> queue;
+    for (int b = 0; b < num_blocks; ++b) {
+        if (pending[b] == 0) queue.push_back(b);
+    }
+    int visited = 0, next_cut = 0;
+    for (size_t head = 0; visited < num_blocks; ++head) {
+        if (head == queue.size()) {
+            while (topo_index_[next_cut] >= 0 || pending[next_cut] == 0) ++next_cut;
+            boundary_[next_cut] = 1;
+            pending[next_cut] = 0;
+            queue.push_back(next_cut);
+        }
+        int b = queue[head];
+        topo_index_[b] = visited++;
+        for (int i = fanout_begin_[b]; i < fanout_begin_[b + 1]; ++i) {
+            int sink = conn_sink_[fanout_[i]];
+            if (sink < 0 || boundary_[sink] || topo_index_[sink] >= 0 || pending[sink] == 0) continue;
+            if (--pending[sink] == 0) queue.push_back(sink);
+        }
+    }
+
+    // Tudo pendente: a primeira propagação visita todos os blocos
+    arrival_.assign(num_blocks, 0.0f);
+    out_dn_.assign(num_blocks, 0.0f);
+    queued_forward_.assign(num_blocks, 1);
+    queued_backward_.assign(num_blocks, 1);
+    dirty_forward_.resize(num_blocks);
+    dirty_backward_.resize(num_blocks);
+    for (int b = 0; b < num_blocks; ++b) {
+        dirty_forward_[b] = dirty_backward_[b] = b;
+    }
+    // Conexões órfãs indexadas pelo bloco sink: o atraso restante dele entra no caminho
+    orphan_of_conn_.assign(conn_driver_.size(), -1);
+    orphan_begin_.assign(num_blocks + 2, 0);
+    for (size_t i = 0; i < orphan_conns_.size(); ++i) {
+        int c = orphan_conns_[i];
+        orphan_of_conn_[c] = static_cast<int>(i);
+        orphan_begin_[conn_sink_[c] + 2]++;  // Sink -1 ocupa a posição 0
+    }
+    for (int b = 0; b <= num_blocks; ++b) orphan_begin_[b + 1] += orphan_begin_[b];
+    orphan_by_sink_.resize(orphan_conns_.size());
+    std::vector<int> orphan_pos(orphan_begin_.begin(), orphan_begin_.end() - 1);
+    for (size_t i = 0; i < orphan_conns_.size(); ++i) {
+        orphan_by_sink_[orphan_pos[conn_sink_[orphan_conns_[i]] + 1]++] = static_cast<int>(i);
+    }
+    rebuildPathHeap();
+
+    critical_path_ = 0.0f;
+    ready_ = false;
+}
+
+void TimingAnalyzer::updateNet(const RoutingGraph& graph, int net, const RouteTree& tree) {
+    if (!tree.routed) return;
+
+    std::vector<float> delays;
+    elmoreDelays(graph, tree, delays);
+
+    int first = conn_begin_[net];
+    int count = std::min<int>(conn_begin_[net + 1] - first, static_cast<int>(delays.size()));
+    for (int k = 0; k < count; ++k) {
+        int c = first + k;
+        if (delays[k] == conn_delay_[c]) continue;
+        conn_delay_[c] = delays[k];
+        if (orphan_of_conn_[c] >= 0) touchPath(static_cast<int>(arrival_.size()) + orphan_of_conn_[c]);
+
+        // A chegada no sink e o atraso restante no driver mudam
+        int sink = conn_sink_[c], driver = conn_driver_[c];
+        if (sink >= 0 && !queued_forward_[sink]) {
+            queued_forward_[sink] = 1;
+            dirty_forward_.push_back(sink);
+        }
+        if (driver >= 0 && !queued_backward_[driver]) {
+            queued_backward_[driver] = 1;
+            dirty_backward_.push_back(driver);
+        }
+    }
+}
+
+void TimingAnalyzer::update() {
+    // Para frente em ordem topológica (heap de mínimo pelo índice)
+    auto later = [&](int a, int b) { return topo_index_[a] > topo_index_[b]; };
+    std::make_heap(dirty_forward_.begin(), dirty_forward_.end(), later);
+    while (!dirty_forward_.empty()) {
+        std::pop_heap(dirty_forward_.begin(), dirty_forward_.end(), later);
+        int b = dirty_forward_.back();
+        dirty_forward_.pop_back();
+        queued_forward_[b] = 0;
+        if (!updateArrival(b)) continue;
+        touchPath(b);
+
+        for (int i = fanout_begin_[b]; i < fanout_begin_[b + 1]; ++i) {
+            int sink = conn_sink_[fanout_[i]];
+            if (sink < 0 || boundary_[sink] || queued_forward_[sink]) continue;
+            queued_forward_[sink] = 1;
+            dirty_forward_.push_back(sink);
+            std::push_heap(dirty_forward_.begin(), dirty_forward_.end(), later);
+        }
+    }
+
+    // Para trás em ordem topológica reversa (heap de máximo)
+    auto earlier = [&](int a, int b) { return topo_index_[a] < topo_index_[b]; };
+    std::make_heap(dirty_backward_.begin(), dirty_backward_.end(), earlier);
+    while (!dirty_backward_.empty()) {
+        std::pop_heap(dirty_backward_.begin(), dirty_backward_.end(), earlier);
+        int b = dirty_backward_.back();
+        dirty_backward_.pop_back();
+        queued_backward_[b] = 0;
+        if (!updateDownstream(b)) continue;
+        touchPath(b);
+        for (int i = orphan_begin_[b + 1]; i < orphan_begin_[b + 2]; ++i) {
+            touchPath(static_cast<int>(arrival_.size()) + orphan_by_sink_[i]);
+        }
+        if (boundary_[b]) continue;
+
+        for (int i = fanin_begin_[b]; i < fanin_begin_[b + 1]; ++i) {
+            int driver = conn_driver_[fanin_[i]];
+            if (driver < 0 || queued_backward_[driver]) continue;
+            queued_backward_[driver] = 1;
+            dirty_backward_.push_back(driver);
+            std::push_heap(dirty_backward_.begin(), dirty_backward_.end(), earlier);
+        }
+    }
+
+    // Todo caminho passa por algum bloco ou começa numa conexão sem driver.
+    // O máximo vem do heap: entradas vencidas (valor diferente do atual) saem
+    // do topo; o resto do heap não é tocado
+    auto smaller = [](const PathEntry& a, const PathEntry& b) { return a.delay < b.delay; };
+    while (!path_heap_.empty() && path_heap_.front().delay != pathDelay(path_heap_.front().item)) {
+        std::pop_heap(path_heap_.begin(), path_heap_.end(), smaller);
+        path_heap_.pop_back();
+    }
+    critical_path_ = path_heap_.empty() ? 0.0f : std::max(0.0f, path_heap_.front().delay);
+    ready_ = true;
+}
+
+float TimingAnalyzer::pathDelay(int item) const {
+    const int num_blocks = static_cast<int>(arrival_.size());
+    if (item < num_blocks) return arrival_[item] + out_dn_[item];
+    int c = orphan_conns_[item - num_blocks];
+    return conn_delay_[c] + downstream(conn_sink_[c]);
+}
+
+void TimingAnalyzer::touchPath(int item) {
+    // Entradas vencidas acumuladas: reconstruir em O(itens), amortizado
+    const size_t num_items = arrival_.size() + orphan_conns_.size();
+    if (path_heap_.size() > 4 * num_items + 64) {
+        rebuildPathHeap();
+        return;
+    }
+    path_heap_.push_back({pathDelay(item), item});
+    std::push_heap(path_heap_.begin(), path_heap_.end(),
+                   [](const PathEntry& a, const PathEntry& b) { return a.delay < b.delay; });
+}
+
+void TimingAnalyzer::rebuildPathHeap() {
+    const int num_items = static_cast<int>(arrival_.size() + orphan_conns_.size());
+    path_heap_.clear();
+    path_heap_.reserve(num_items);
+    for (int item = 0; item < num_items; ++item) path_heap_.push_back({pathDelay(item), item});
+    std::make_heap(path_heap_.begin(), path_heap_.end(),
+                   [](const PathEntry& a, const PathEntry& b) { return a.delay < b.delay; });
+}
+
+bool TimingAnalyzer::updateArrival(int block) {
+    float value = 0.0f;
+    if (!boundary_[block]) {
+        for (int i = fanin_begin_[block]; i < fanin_begin_[block + 1]; ++i) {
+            int c = fanin_[i];
+            value = std::max(value, arrival(conn_driver_[c]) + conn_delay_[c]);
+        }
+        value += options_.block_delay;
+    }
+    if (value == arrival_[block]) return false;
+    arrival_[block] = value;
+    return true;
+}
+
+bool TimingAnalyzer::updateDownstream(int block) {
+    float value = 0.0f;
+    for (int i = fanout_begin_[block]; i < fanout_begin_[block + 1]; ++i) {
+        int c = fanout_[i];
+        value = std::max(value, conn_delay_[c] + downstream(conn_sink_[c]));
+    }
+    if (value == out_dn_[block]) return false;
+    out_dn_[block] = value;
+    return true;
+}
+
+float TimingAnalyzer::downstream(int block) const {
+    if (block < 0 || boundary_[block]) return 0.0f;
+    return options_.block_delay + out_dn_[block];
+}
+
+float TimingAnalyzer::period() const {
+    return options_.clock_period > 0.0f ? options_.clock_period : critical_path_;
+}
+
+float TimingAnalyzer::slack(int net, int sink) const {
+    int c = conn_begin_[net] + sink;
+    return period() - (arrival(conn_driver_[c]) + conn_delay_[c] + downstream(conn_sink_[c]));
+}
+
+float TimingAnalyzer::criticality(int net, int sink) const {
+    if (critical_path_ <= 0.0f) return 0.0f;
+
+    float crit = 1.0f - slack(net, sink) / critical_path_;
+    crit = std::min(std::max(crit, 0.0f), options_.max_criticality);
+    return options_.criticality_exp == 1.0f ? crit : std::pow(crit, options_.criticality_exp);
+}
+
+void TimingAnalyzer::exportTo(TimingConstraints& timing, const std::vector<Net>& nets) const {
+    timing.clock_period = period();
+    timing.arrival_times.clear();
+    timing.required_times.clear();
+    timing.slacks.clear();
+
+    for (size_t n = 0; n < nets.size() && n + 1 < conn_begin_.size(); ++n) {
+        for (int c = conn_begin_[n]; c < conn_begin_[n + 1]; ++c) {
+            int node = nets[n].sinks[c - conn_begin_[n]];
+            float arrival_time = arrival(conn_driver_[c]) + conn_delay_[c];
+            float required = period() - downstream(conn_sink_[c]);
+
+            auto it = timing.slacks.find(node);
+            if (it == timing.slacks.end() || required - arrival_time < it->second) {
+                timing.arrival_times[node] = arrival_time;
+                timing.required_times[node] = required;
+                timing.slacks[node] = required - arrival_time;
+            }
+        }
+    }
+}
+
+void TimingAnalyzer::elmoreDelays(const RoutingGraph& graph, const RouteTree& tree,
+                                  std::vector<float>& delays) {
+    const RRNodeStore& nodes = graph.nodes;
+    const int count = static_cast<int>(tree.nodes.size());
+    auto validSwitch = [&](int sw) { return sw >= 0 && sw < static_cast<int>(switches_.size()); };
+
+    // Capacitância a jusante de cada nó: o próprio fio, o Cout do switch que o
+    // alimenta e, por filho, o Cin do switch mais (se não bufferizado) a
+    // capacitância da subárvore. Filhos têm índice maior que o pai
+    c_down_.assign(count, 0.0f);
+    for (int i = 0; i < count; ++i) {
+        int sw = tree.nodes[i].switch_id;
+        c_down_[i] = nodes.rc(tree.nodes[i].rr_node).C;
+        if (i > 0 && validSwitch(sw)) c_down_[i] += static_cast<float>(switches_[sw].Cout);
+    }
+    for (int i = count - 1; i > 0; --i) {
+        int sw = tree.nodes[i].switch_id;
+        float load = validSwitch(sw) ? static_cast<float>(switches_[sw].Cin) : 0.0f;
+        if (!validSwitch(sw) || !switch_buffered_[sw]) load += c_down_[i];
+        c_down_[tree.nodes[i].parent] += load;
+    }
+
+    // Elmore da raiz para as folhas: cada resistência entre o pai e o nó vê a
+    // capacitância a jusante dela (o fio como modelo pi)
+    node_delay_.assign(count, 0.0f);
+    for (int i = 1; i < count; ++i) {
+        const RouteTreeNode& tree_node = tree.nodes[i];
+        const RRNodeRC& rc = nodes.rc(tree_node.rr_node);
+        double delay = rc.R * (c_down_[i] - 0.5 * rc.C);
+        if (validSwitch(tree_node.switch_id)) {
+            const Switch& sw = switches_[tree_node.switch_id];
+            delay += sw.Tdel + sw.R * c_down_[i];
+        }
+        node_delay_[i] = node_delay_[tree_node.parent] + static_cast<float>(delay * 1e9);
+    }
+
+    delays.resize(tree.sink_branches.size());
+    for (size_t k = 0; k < tree.sink_branches.size(); ++k) {
+        int branch = tree.sink_branches[k];
+        delays[k] = branch >= 0 ? node_delay_[branch] : 0.0f;
+    }
+}
@@ -0,0 +1,265 @@
+#include "routing/types.h"
+#include "routing/thread_pool.h"
+#include <algorithm>
+#include <unordered_map>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <cstring>
+#include <functional>
+
+void RRNodeStore::resize(size_t n) {
+    types.assign(n, 0);
+    x_low.assign(n, 0);
+    y_low.assign(n, 0);
+    x_high.assign(n, 0);
+    y_high.assign(n, 0);
+    ptc.assign(n, 0);
+    capacity.assign(n, 0);
+    base_cost.assign(n, 0.0f);
+    delay.assign(n, 0.0f);
+    name_id.assign(n, 0);
+    rc_index.assign(n, 0);
+    if (rc_data.empty()) rc_data.push_back({0.0f, 0.0f});
+}
+
+int RRNodeStore::add(const RRNode& node) {
+    int id = static_cast<int>(size());
+    int name = internName(node.name);
+    types.push_back(0);
+    x_low.push_back(0);
+    y_low.push_back(0);
+    x_high.push_back(0);
+    y_high.push_back(0);
+    ptc.push_back(0);
+    capacity.push_back(0);
+    base_cost.push_back(0.0f);
+    delay.push_back(0.0f);
+    name_id.push_back(0);
+    rc_index.push_back(0);
+    if (rc_data.empty()) rc_data.push_back({0.0f, 0.0f});
+    set(id, node, name);
+    return id;
+}
+
+// Estreita para o tipo compacto dos arrays. O builder rejeita grids e
+// arquiteturas que não cabem antes de gerar os nós; aqui só se confere
+template <typename T>
+static T narrow(int value) {
+    assert(value >= std::numeric_limits<T>::min() && value <= std::numeric_limits<T>::max());
+    return static_cast<T>(value);
+}
+
+void RRNodeStore::set(int id, const RRNode& node, int name) {
+    types[id] = static_cast<uint8_t>(node.type);
+    x_low[id] = narrow<int16_t>(node.x_low);
+    y_low[id] = narrow<int16_t>(node.y_low);
+    x_high[id] = narrow<int16_t>(node.x_high);
+    y_high[id] = narrow<int16_t>(node.y_high);
+    ptc[id] = narrow<int16_t>(node.ptc);
+    capacity[id] = narrow<uint16_t>(node.capacity);
+    base_cost[id] = node.base_cost;
+    delay[id] = node.delay;
+    name_id[id] = narrow<uint16_t>(name);
+}
+
+RRNode RRNodeStore::get(int id) const {
+    RRNode node;
+    node.id = id;
+    node.type = type(id);
+    node.x = node.x_low = x_low[id];
+    node.y = node.y_low = y_low[id];
+    node.x_high = x_high[id];
+    node.y_high = y_high[id];
+    node.ptc = ptc[id];
+    node.capacity = capacity[id];
+    node.base_cost = base_cost[id];
+    node.delay = delay[id];
+    node.name = name(id);
+    return node;
+}
+
+int RRNodeStore::internName(const std::string& name) {
+    if (name_index_.empty() && !names.empty()) {
+        // Tabela carregada do cache: reconstruir o índice
+        for (size_t i = 0; i < names.size(); ++i) {
+            name_index_.emplace(names[i], static_cast<int>(i));
+        }
+    }
+    auto it = name_index_.find(name);
+    if (it != name_index_.end()) return it->second;
+    int index = static_cast<int>(names.size());
+    names.push_back(name);
+    name_index_.emplace(name, index);
+    return index;
+}
+
+int RRNodeStore::internRC(float R, float C) {
+    if (rc_data.empty()) rc_data.push_back({0.0f, 0.0f});
+    for (size_t i = 0; i < rc_data.size(); ++i) {
+        if (rc_data[i].R == R && rc_data[i].C == C) return static_cast<int>(i);
+    }
+    rc_data.push_back({R, C});
+    return static_cast<int>(rc_data.size()) - 1;
+}
+
+// Executa task(i) para i em [0, count), no pool se houver
+static void forEachBand(ThreadPool* pool, int count, const std::function<void(int)>& task) {
+    if (pool && count > 1) {
+        pool->run(count, [&](int i, int) { task(i); });
+    } else {
+        for (int i = 0; i < count; ++i) task(i);
+    }
+}
+
+// Chave de internação de um par (switch, atraso)
+static uint64_t switchKey(const RREdge& edge) {
+    uint32_t delay_bits;
+    static_assert(sizeof(delay_bits) == sizeof(float), "float de 32 bits");
+    std::memcpy(&delay_bits, &edge.delay, sizeof(float));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(edge.switch_id)) << 32) | delay_bits;
+}
+
+// Counting sort das arestas por nó de origem (e de destino para o reverso).
+// Cada faixa de nós recebe, em ordem de faixa geradora, as arestas cujo
+// extremo cai nela e preenche sozinha o seu trecho de offsets/adj
+static void buildCSR(
+    const std::vector<std::vector<RREdge>>& band_edges,
+    const std::vector<std::vector<int>>& band_switch,
+    const std::vector<int>& band_begin,
+    size_t num_nodes,
+    bool reverse,
+    ThreadPool* pool,
+    RRArray<int>& offsets,
+    RRArray<RRAdjEdge>& adj
+) {
+    const int num_bands = static_cast<int>(band_edges.size());
+    auto bandOf = [&](int node) {
+        return static_cast<int>(std::upper_bound(band_begin.begin(), band_begin.end(), node)
+                                - band_begin.begin()) - 1;
+    };
+    auto bandEnd = [&](int band) {
+        return band + 1 < num_bands ? band_begin[band + 1] : static_cast<int>(num_nodes);
+    };
+
+    // routed[src][dst]: arestas da lista src cujo extremo pertence à faixa dst
+    std::vector<std::vector<std::vector<int>>> routed(num_bands);
+    if (num_bands > 1) {
+        forEachBand(pool, num_bands, [&](int b) {
+            routed[b].assign(num_bands, std::vector<int>());
+            const auto& edges = band_edges[b];
+            for (size_t i = 0; i < edges.size(); ++i) {
+                int key = reverse ? edges[i].to_node : edges[i].from_node;
+                routed[b][bandOf(key)].push_back(static_cast<int>(i));
+            }
+        });
+    }
+
+    auto forEachEdge = [&](int dst, auto&& visit) {
+        if (num_bands == 1) {
+            for (size_t i = 0; i < band_edges[0].size(); ++i) visit(band_edges[0][i], band_switch[0][i]);
+            return;
+        }
+        for (int b = 0; b < num_bands; ++b) {
+            for (int i : routed[b][dst]) visit(band_edges[b][i], band_switch[b][i]);
+        }
+    };
+
+    // Início de cada faixa em adj
+    std::vector<size_t> edge_begin(num_bands + 1, 0);
+    for (int d = 0; d < num_bands; ++d) {
+        size_t count = 0;
+        if (num_bands == 1) {
+            count = band_edges[0].size();
+        } else {
+            for (int b = 0; b < num_bands; ++b) count += routed[b][d].size();
+        }
+        edge_begin[d + 1] = edge_begin[d] + count;
+    }
+
+    offsets.assign(num_nodes + 1, 0);
+    adj.resize(edge_begin[num_bands]);
+    offsets[num_nodes] = static_cast<int>(edge_begin[num_bands]);
+
+    forEachBand(pool, num_bands, [&](int d) {
+        const int first = band_begin[d];
+        const int last = bandEnd(d);
+        std::vector<int> cursor(last - first + 1, 0);
+        forEachEdge(d, [&](const RREdge& edge, int) {
+            int key = reverse ? edge.to_node : edge.from_node;
+            cursor[key - first + 1]++;
+        });
+        cursor[0] = static_cast<int>(edge_begin[d]);
+        for (int i = 0; i < last - first; ++i) {
+            cursor[i + 1] += cursor[i];
+        }
+        std::copy(cursor.begin(), cursor.end() - 1, offsets.begin() + first);
+
+        forEachEdge(d, [&](const RREdge& edge, int rr_switch) {
+            int key = reverse ? edge.to_node : edge.from_node;
+            int other = reverse ? edge.from_node : edge.to_node;
+            adj[cursor[key - first]++] = {other, rr_switch};
+        });
+    });
+}
+
+void RoutingGraph::freeze() {
+    if (isFrozen() && edges.empty()) return;
+
+    std::vector<std::vector<RREdge>> band_edges(1);
+    band_edges[0].swap(edges);
+    freeze(band_edges, std::vector<int>(1, 0), nullptr);
+}
+
+void RoutingGraph::freeze(std::vector<std::vector<RREdge>>& band_edges,
+                          const std::vector<int>& band_begin, ThreadPool* pool) {
+    const int num_bands = static_cast<int>(band_edges.size());
+
+    // Internar pares (switch, atraso): poucos tipos distintos por arquitetura.
+    // Cada lista interna localmente; as tabelas locais são unidas em ordem
+    std::vector<std::vector<int>> band_switch(num_bands);
+    std::vector<std::vector<RRSwitch>> local_switches(num_bands);
+    forEachBand(pool, num_bands, [&](int b) {
+        std::unordered_map<uint64_t, int> switch_index;
+        const auto& list = band_edges[b];
+        band_switch[b].resize(list.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+            auto it = switch_index.find(switchKey(list[i]));
+            if (it == switch_index.end()) {
+                it = switch_index.emplace(switchKey(list[i]), static_cast<int>(local_switches[b].size())).first;
+                local_switches[b].push_back({list[i].switch_id, list[i].delay});
+            }
+            band_switch[b][i] = it->second;
+        }
+    });
+
+    std::unordered_map<uint64_t, int> switch_index;
+    for (size_t i = 0; i < switches.size(); ++i) {
+        switch_index.emplace(switchKey({0, 0, switches[i].switch_id, switches[i].delay}), static_cast<int>(i));
+    }
+    std::vector<std::vector<int>> remap(num_bands);
+    for (int b = 0; b < num_bands; ++b) {
+        for (const auto& sw : local_switches[b]) {
+            uint64_t key = switchKey({0, 0, sw.switch_id, sw.delay});
+            auto it = switch_index.find(key);
+            if (it == switch_index.end()) {
+                it = switch_index.emplace(key, static_cast<int>(switches.size())).first;
+                switches.push_back(sw);
+            }
+            remap[b].push_back(it->second);
+        }
+    }
+    forEachBand(pool, num_bands, [&](int b) {
+        for (int& s : band_switch[b]) s = remap[b][s];
+    });
+
+    buildCSR(band_edges, band_switch, band_begin, nodes.size(), false, pool, out_offsets, out_edges);
+    buildCSR(band_edges, band_switch, band_begin, nodes.size(), true, pool, in_offsets, in_edges);
+
+    // As listas de construção não são mais necessárias
+    for (auto& list : band_edges) {
+        std::vector<RREdge>().swap(list);
+    }
+    std::vector<RREdge>().swap(edges);
+    occupancy.init(nodes);
+}